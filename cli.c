@@ -0,0 +1,811 @@
+/* Command-line front end: --headless, --bench and --job modes. Built into the GTK
+ * application and, with NQUEENS_CLI_MAIN defined, into the standalone nqueens-cli. */
+#include "cli.h"
+#include "nqueens_internal.h"
+#include <pthread.h>
+#include <time.h>
+#include <errno.h>
+#ifndef _WIN32
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <poll.h>
+#include <signal.h>
+#endif
+
+#define BENCH_MAX_REPEATS 1000
+#define JOB_MIN_UNITS 1024
+#define JOB_MAX_DEPTH 6
+#define JOB_MAX_ATTEMPTS 3
+
+static bool parse_size_range(const char *text, int *first, int *last) {
+    char *end;
+    long lo = strtol(text, &end, 10);
+    long hi = lo;
+    if (end == text) return false;
+    if (strncmp(end, "..", 2) == 0) {
+        const char *rest = end + 2;
+        hi = strtol(rest, &end, 10);
+        if (end == rest) return false;
+    }
+    if (*end != '\0' || lo < 1 || hi < lo || hi > MIN_CONFLICTS_MAX_SIZE) return false;
+
+    *first = (int)lo;
+    *last = (int)hi;
+    return true;
+}
+
+static bool parse_method_list(const char *text, bool *selected) {
+    char buffer[256];
+    snprintf(buffer, sizeof(buffer), "%s", text);
+
+    for (char *name = strtok(buffer, ","); name; name = strtok(NULL, ",")) {
+        bool known = false;
+        for (int m = 0; m < METHOD_COUNT; m++) {
+            if (strcmp(name, "all") == 0 || strcmp(name, method_names[m]) == 0) {
+                selected[m] = true;
+                known = true;
+            }
+        }
+        if (!known) return false;
+    }
+    return true;
+}
+
+static void print_headless_usage(FILE *stream) {
+    fprintf(stream,
+        "usage: main --headless --n N|FIRST..LAST [--method NAME[,NAME...]|all] [--dump FILE|-] [--seed S] [--stats]\n"
+        "       main --headless --n N|FIRST..LAST --nth K\n"
+        "       main --headless --n N|FIRST..LAST [--pin COL:ROW[,...]] [--block COL:ROW[,...]]\n"
+        "methods:");
+    for (int m = 0; m < METHOD_COUNT; m++) {
+        fprintf(stream, " %s", method_names[m]);
+    }
+    fprintf(stream, "\n");
+}
+
+/* --nth: prints the K-th solution (1-based, lexicographic) of each size by unranking.
+ * wall_ms is the whole cost from an empty index; total is only printed when the walk
+ * had to count every subtree, which it does when K is out of range. */
+static int print_nth_solutions(int first, int last, long long nth) {
+    SolutionIndex index = {0};
+    for (int n = first; n <= last; n++) {
+        CountState state = {0, NULL, false, NULL};
+        unsigned char placement[BITBOARD_MAX_SIZE];
+        solution_index_reset(&index, n);
+
+        uint64_t start = monotonic_ns();
+        bool found = solution_index_unrank(&index, nth - 1, placement, &state);
+        double wall_ms = (monotonic_ns() - start) / 1e6;
+
+        printf("{\"n\":%d,\"rank\":%lld", n, nth);
+        long long total = solution_index_known_total(&index);
+        if (total >= 0) printf(",\"total\":%lld", total);
+        printf(",\"wall_ms\":%.3f", wall_ms);
+        if (found) {
+            printf(",\"solution\":[");
+            for (int j = 0; j < n; j++) printf(j ? ",%d" : "%d", placement[j]);
+            printf("]");
+        }
+        printf("}\n");
+        fflush(stdout);
+    }
+    solution_index_free(&index);
+    return 0;
+}
+
+/* Parses "COL:ROW[,COL:ROW...]" into at most BITBOARD_MAX_SIZE * BITBOARD_MAX_SIZE
+ * squares. Returns -1 on malformed input, on squares past that limit, and when
+ * one_per_column is set and a column is given twice. */
+static int parse_squares(const char *text, int squares[][2], bool one_per_column) {
+    uint32_t columns = 0;
+    int count = 0;
+    while (*text) {
+        if (count == BITBOARD_MAX_SIZE * BITBOARD_MAX_SIZE) return -1;
+        char *end;
+        long col = strtol(text, &end, 10);
+        if (end == text || *end != ':') return -1;
+        text = end + 1;
+        long row = strtol(text, &end, 10);
+        if (end == text || col < 0 || row < 0 || col >= BITBOARD_MAX_SIZE || row >= BITBOARD_MAX_SIZE) return -1;
+        if (one_per_column && (columns & (1u << col))) return -1;
+        columns |= 1u << col;
+        squares[count][0] = (int)col;
+        squares[count][1] = (int)row;
+        count++;
+        text = end;
+        if (*text == ',') text++;
+        else if (*text) return -1;
+    }
+    return count;
+}
+
+/* --pin/--block: completes the constrained board for every size in the range that
+ * contains all the given squares. */
+static int print_completions(int first, int last, int squares[][2], int pin_count, int block_count) {
+    for (int n = first; n <= last; n++) {
+        BoardConstraints constraints;
+        board_constraints_reset(&constraints, n);
+        bool fits = true;
+        for (int k = 0; k < pin_count + block_count; k++) {
+            int col = squares[k][0], row = squares[k][1];
+            if (col >= n || row >= n) fits = false;
+            else if (k < pin_count) constraints.pinned[col] = row;
+            else constraints.blocked[col] |= 1u << row;
+        }
+        if (!fits) continue;
+
+        CountState state = {0, NULL, false, NULL};
+        unsigned char placement[BITBOARD_MAX_SIZE];
+        uint64_t start = monotonic_ns();
+        bool found = complete_board(&constraints, placement, &state);
+        double wall_ms = (monotonic_ns() - start) / 1e6;
+
+        printf("{\"n\":%d,\"found\":%s,\"nodes\":%lld,\"wall_ms\":%.3f", n, found ? "true" : "false",
+               state.operations, wall_ms);
+        if (found) {
+            printf(",\"solution\":[");
+            for (int j = 0; j < n; j++) printf(j ? ",%d" : "%d", placement[j]);
+            printf("]");
+        }
+        printf("}\n");
+        fflush(stdout);
+    }
+    return 0;
+}
+
+/* Batch entry point: runs the selected methods over a range of sizes without GTK and
+ * prints one JSON line per run. --dump writes every stored solution as a JSON line too
+ * (for "symmetric" only the fundamental placements). Sizes above 32 are only solved by
+ * "minconflicts"; --seed makes its runs reproducible. --stats adds the search statistics
+ * (nodes per column, pruned branches, leaves, time per phase) to each line. */
+static int run_headless(int argc, char **argv) {
+    int first = 8, last = 8;
+    bool selected[METHOD_COUNT] = {false};
+    bool any_method = false;
+    bool with_stats = false;
+    const char *dump_path = NULL;
+    const char *pin_text = NULL;
+    const char *block_text = NULL;
+    long long nth = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--headless") == 0) continue;
+        if (i + 1 < argc && strcmp(argv[i], "--n") == 0) {
+            if (!parse_size_range(argv[++i], &first, &last)) {
+                fprintf(stderr, "invalid size range: %s\n", argv[i]);
+                return 2;
+            }
+        } else if (i + 1 < argc && strcmp(argv[i], "--method") == 0) {
+            if (!parse_method_list(argv[++i], selected)) {
+                fprintf(stderr, "unknown method in: %s\n", argv[i]);
+                print_headless_usage(stderr);
+                return 2;
+            }
+            any_method = true;
+        } else if (strcmp(argv[i], "--stats") == 0) {
+            with_stats = true;
+        } else if (i + 1 < argc && strcmp(argv[i], "--pin") == 0) {
+            pin_text = argv[++i];
+        } else if (i + 1 < argc && strcmp(argv[i], "--block") == 0) {
+            block_text = argv[++i];
+        } else if (i + 1 < argc && strcmp(argv[i], "--dump") == 0) {
+            dump_path = argv[++i];
+        } else if (i + 1 < argc && strcmp(argv[i], "--seed") == 0) {
+            solver_seed = strtoull(argv[++i], NULL, 0);
+        } else if (i + 1 < argc && strcmp(argv[i], "--nth") == 0) {
+            nth = atoll(argv[++i]);
+            if (nth < 1) {
+                fprintf(stderr, "--nth must be at least 1\n");
+                return 2;
+            }
+        } else {
+            print_headless_usage(strcmp(argv[i], "--help") == 0 ? stdout : stderr);
+            return strcmp(argv[i], "--help") == 0 ? 0 : 2;
+        }
+    }
+    if (!any_method) selected[METHOD_BITBOARD] = true;
+    if (nth > 0) return print_nth_solutions(first, MIN(last, BITBOARD_MAX_SIZE), nth);
+    if (pin_text || block_text) {
+        static int squares[2 * BITBOARD_MAX_SIZE * BITBOARD_MAX_SIZE][2];
+        int pins = pin_text ? parse_squares(pin_text, squares, true) : 0;
+        int blocks = block_text && pins >= 0 ? parse_squares(block_text, squares + pins, false) : 0;
+        if (pins < 0 || blocks < 0) {
+            fprintf(stderr, "invalid square list, expected COL:ROW[,COL:ROW...] with one pin per column\n");
+            return 2;
+        }
+        return print_completions(first, MIN(last, BITBOARD_MAX_SIZE), squares, pins, blocks);
+    }
+
+    FILE *dump = NULL;
+    if (dump_path) {
+        dump = strcmp(dump_path, "-") == 0 ? stdout : fopen(dump_path, "w");
+        if (!dump) {
+            perror(dump_path);
+            return 1;
+        }
+    }
+
+    for (int n = first; n <= last; n++) {
+        for (int m = 0; m < METHOD_COUNT; m++) {
+            if (!selected[m] || n > method_max_size((SolverMethod)m)) continue;
+
+            SolverOutput out;
+            solver_output_init(&out, NULL, n);
+            out.dump = dump;
+            out.dump_label = method_names[m];
+
+            uint64_t start = monotonic_ns();
+            run_solver((SolverMethod)m, n, &out);
+            double wall_ms = (monotonic_ns() - start) / 1e6;
+
+            printf("{\"n\":%d,\"method\":\"%s\",\"solutions\":%lld,\"operations\":%lld,\"wall_ms\":%.3f",
+                   n, method_names[m], out.solution_count, out.operation_count, wall_ms);
+            if (with_stats) {
+                SolverStats stats;
+                solver_output_snapshot_stats(&out, &stats);
+                fputs(",\"stats\":", stdout);
+                write_stats_json(stdout, &stats, n);
+            }
+            printf("}\n");
+            fflush(stdout);
+        }
+    }
+
+    if (dump && dump != stdout) fclose(dump);
+    return 0;
+}
+
+static int compare_doubles(const void *a, const void *b) {
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/* Resets the kernel's peak-RSS watermark so each benchmark group reports its own peak;
+ * where that is not possible the process-wide maximum is reported instead. */
+static void reset_peak_rss(void) {
+#ifdef __linux__
+    FILE *clear_refs = fopen("/proc/self/clear_refs", "w");
+    if (clear_refs) {
+        fputs("5", clear_refs);
+        fclose(clear_refs);
+    }
+#endif
+}
+
+static long peak_rss_kb(void) {
+#ifdef __linux__
+    FILE *status = fopen("/proc/self/status", "r");
+    if (status) {
+        char line[256];
+        long kb = -1;
+        while (fgets(line, sizeof(line), status)) {
+            if (sscanf(line, "VmHWM: %ld kB", &kb) == 1) break;
+        }
+        fclose(status);
+        if (kb >= 0) return kb;
+    }
+#endif
+#ifndef _WIN32
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) return usage.ru_maxrss;
+#endif
+    return 0;
+}
+
+static bool find_baseline_median(const char *path, int n, const char *method, double *median_ms) {
+    FILE *baseline = fopen(path, "r");
+    if (!baseline) return false;
+
+    char line[512];
+    bool found = false;
+    while (!found && fgets(line, sizeof(line), baseline)) {
+        int line_n;
+        char line_method[64];
+        double line_median;
+        if (sscanf(line, "{\"n\":%d,\"method\":\"%63[^\"]\",\"runs\":%*d,\"median_ms\":%lf", &line_n, line_method, &line_median) == 3
+            && line_n == n && strcmp(line_method, method) == 0) {
+            *median_ms = line_median;
+            found = true;
+        }
+    }
+    fclose(baseline);
+    return found;
+}
+
+static void print_bench_usage(FILE *stream) {
+    fprintf(stream,
+        "usage: main --bench [--n N|FIRST..LAST] [--method NAME[,NAME...]|all] [--repeat R] [--warmup W]\n"
+        "                    [--save FILE] [--baseline FILE] [--threshold PERCENT] [--generic-kernels]\n"
+        "                    [--trace]\n");
+}
+
+/* Times every selected method over a range of sizes. Each (n, method) group runs the
+ * warm-up solves first, then R timed solves, and prints one JSON line with median/p95
+ * wall time, throughput and peak RSS. --save writes those lines as a baseline, and
+ * --baseline compares against one: medians slower than the threshold are flagged and
+ * make the exit status 1. --generic-kernels runs the counting engines on bitboard_count
+ * instead of the per-size kernels, for comparing the two through a saved baseline.
+ * --trace publishes search snapshots as the GUI does, to measure what they cost. */
+static int run_benchmark(int argc, char **argv) {
+    int first = 6, last = 10;
+    int repeat = 5, warmup = 1;
+    double threshold = 10.0;
+    bool selected[METHOD_COUNT] = {false};
+    bool any_method = false;
+    const char *save_path = NULL;
+    const char *baseline_path = NULL;
+    bool trace = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--bench") == 0) continue;
+        if (i + 1 < argc && strcmp(argv[i], "--n") == 0) {
+            if (!parse_size_range(argv[++i], &first, &last)) {
+                fprintf(stderr, "invalid size range: %s\n", argv[i]);
+                return 2;
+            }
+        } else if (i + 1 < argc && strcmp(argv[i], "--method") == 0) {
+            if (!parse_method_list(argv[++i], selected)) {
+                fprintf(stderr, "unknown method in: %s\n", argv[i]);
+                return 2;
+            }
+            any_method = true;
+        } else if (i + 1 < argc && strcmp(argv[i], "--repeat") == 0) {
+            repeat = atoi(argv[++i]);
+        } else if (i + 1 < argc && strcmp(argv[i], "--warmup") == 0) {
+            warmup = atoi(argv[++i]);
+        } else if (i + 1 < argc && strcmp(argv[i], "--threshold") == 0) {
+            threshold = atof(argv[++i]);
+        } else if (i + 1 < argc && strcmp(argv[i], "--save") == 0) {
+            save_path = argv[++i];
+        } else if (i + 1 < argc && strcmp(argv[i], "--baseline") == 0) {
+            baseline_path = argv[++i];
+        } else if (strcmp(argv[i], "--generic-kernels") == 0) {
+            use_specialized_kernels = false;
+        } else if (strcmp(argv[i], "--trace") == 0) {
+            trace = true;
+        } else {
+            print_bench_usage(strcmp(argv[i], "--help") == 0 ? stdout : stderr);
+            return strcmp(argv[i], "--help") == 0 ? 0 : 2;
+        }
+    }
+    if (repeat < 1 || repeat > BENCH_MAX_REPEATS || warmup < 0) {
+        fprintf(stderr, "--repeat must be in 1..%d and --warmup >= 0\n", BENCH_MAX_REPEATS);
+        return 2;
+    }
+    if (!any_method) {
+        for (int m = 0; m < METHOD_COUNT; m++) selected[m] = true;
+    }
+
+    FILE *save = NULL;
+    if (save_path) {
+        save = fopen(save_path, "w");
+        if (!save) {
+            perror(save_path);
+            return 1;
+        }
+    }
+
+    double samples[BENCH_MAX_REPEATS];
+    int regressions = 0;
+    SearchSnapshot snapshot;
+    search_snapshot_init(&snapshot);
+
+    for (int n = first; n <= last; n++) {
+        for (int m = 0; m < METHOD_COUNT; m++) {
+            if (!selected[m] || n > method_max_size((SolverMethod)m)) continue;
+
+            SolverOutput out;
+            reset_peak_rss();
+            for (int r = 0; r < warmup; r++) {
+                solver_output_init(&out, NULL, n);
+                if (trace) out.snapshot = &snapshot;
+                run_solver((SolverMethod)m, n, &out);
+            }
+            for (int r = 0; r < repeat; r++) {
+                solver_output_init(&out, NULL, n);
+                if (trace) out.snapshot = &snapshot;
+                uint64_t start = monotonic_ns();
+                run_solver((SolverMethod)m, n, &out);
+                samples[r] = (monotonic_ns() - start) / 1e6;
+            }
+
+            qsort(samples, repeat, sizeof(double), compare_doubles);
+            double median_ms = (repeat % 2) ? samples[repeat / 2] : (samples[repeat / 2 - 1] + samples[repeat / 2]) / 2;
+            double p95_ms = samples[(int)((repeat * 95 + 99) / 100) - 1];
+            double seconds = median_ms > 0 ? median_ms / 1e3 : 1e-9;
+
+            char result[512];
+            snprintf(result, sizeof(result),
+                     "{\"n\":%d,\"method\":\"%s\",\"runs\":%d,\"median_ms\":%.3f,\"p95_ms\":%.3f,"
+                     "\"nodes_per_sec\":%.0f,\"solutions_per_sec\":%.0f,\"peak_rss_kb\":%ld",
+                     n, method_names[m], repeat, median_ms, p95_ms,
+                     out.operation_count / seconds, out.solution_count / seconds, peak_rss_kb());
+
+            if (save) fprintf(save, "%s}\n", result);
+
+            double baseline_ms;
+            if (baseline_path && find_baseline_median(baseline_path, n, method_names[m], &baseline_ms)) {
+                bool regression = median_ms > baseline_ms * (1.0 + threshold / 100.0);
+                regressions += regression;
+                printf("%s,\"baseline_ms\":%.3f,\"regression\":%s}\n", result, baseline_ms, regression ? "true" : "false");
+            } else {
+                printf("%s}\n", result);
+            }
+            fflush(stdout);
+        }
+    }
+
+    if (save) fclose(save);
+    if (regressions > 0) {
+        fprintf(stderr, "%d regression(s) beyond %.1f%%\n", regressions, threshold);
+        return 1;
+    }
+    return 0;
+}
+
+#ifndef _WIN32
+/* Job mode messages: the parent sends one prefix unit, the worker answers with its counts. */
+typedef struct {
+    int32_t unit;
+    uint32_t rows;
+    uint32_t ld;
+    uint32_t rd;
+} JobRequest;
+
+typedef struct {
+    int32_t unit;
+    int32_t reserved;
+    int64_t solutions;
+    int64_t operations;
+} JobResult;
+
+typedef struct {
+    pid_t pid;
+    int fd;
+    int unit; /* unit in flight, -1 when idle */
+} JobWorker;
+
+static bool read_full(int fd, void *buffer, size_t size) {
+    unsigned char *bytes = buffer;
+    while (size > 0) {
+        ssize_t got = read(fd, bytes, size);
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) return false;
+        bytes += got;
+        size -= got;
+    }
+    return true;
+}
+
+static bool write_full(int fd, const void *buffer, size_t size) {
+    const unsigned char *bytes = buffer;
+    while (size > 0) {
+        ssize_t put = write(fd, bytes, size);
+        if (put < 0 && errno == EINTR) continue;
+        if (put <= 0) return false;
+        bytes += put;
+        size -= put;
+    }
+    return true;
+}
+
+static void job_worker_loop(int fd, int n) {
+    uint32_t all = (n == 32) ? UINT32_MAX : ((1u << n) - 1);
+    CountKernel kernel = select_count_kernel(n);
+    JobRequest request;
+
+    while (read_full(fd, &request, sizeof(request)) && request.unit >= 0) {
+        CountState state = {0, NULL, false, NULL};
+        JobResult result = {request.unit, 0, 0, 0};
+        result.solutions = kernel(all, request.rows, request.ld, request.rd, &state);
+        result.operations = state.operations;
+        if (!write_full(fd, &result, sizeof(result))) break;
+    }
+    close(fd);
+}
+
+static bool job_spawn_worker(JobWorker *worker, int n) {
+    int pair[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, pair) != 0) return false;
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(pair[0]);
+        close(pair[1]);
+        return false;
+    }
+    if (pid == 0) {
+        close(pair[0]);
+        job_worker_loop(pair[1], n);
+        _exit(0);
+    }
+
+    close(pair[1]);
+    worker->pid = pid;
+    worker->fd = pair[0];
+    worker->unit = -1;
+    return true;
+}
+
+/* Reaps a worker whose socket failed and forks a fresh one in its slot; false when
+ * no replacement could be started. */
+static bool job_replace_worker(JobWorker *worker, int n) {
+    close(worker->fd);
+    waitpid(worker->pid, NULL, 0);
+    worker->fd = -1;
+    worker->pid = 0;
+    worker->unit = -1;
+    return job_spawn_worker(worker, n);
+}
+
+/* Reads the completed units of an earlier run. The first line must describe the same
+ * job; lines that do not parse (a write cut short by a crash) are ignored. */
+static bool load_job_checkpoint(FILE *file, int n, int depth, int unit_count, bool *done,
+                                long long *solutions, long long *operations, int *done_count) {
+    char line[256];
+    int file_n, file_depth, file_units;
+    if (!fgets(line, sizeof(line), file)) return true;
+    if (sscanf(line, "nqueens-job n=%d depth=%d units=%d", &file_n, &file_depth, &file_units) != 3
+        || file_n != n || file_depth != depth || file_units != unit_count) {
+        return false;
+    }
+
+    while (fgets(line, sizeof(line), file)) {
+        int unit;
+        long long unit_solutions, unit_operations;
+        if (sscanf(line, "%d %lld %lld", &unit, &unit_solutions, &unit_operations) != 3) continue;
+        if (unit < 0 || unit >= unit_count || done[unit] || !strchr(line, '\n')) continue;
+        done[unit] = true;
+        *solutions += unit_solutions;
+        *operations += unit_operations;
+        (*done_count)++;
+    }
+    return true;
+}
+
+static void print_job_usage(FILE *stream) {
+    fprintf(stream,
+        "usage: main --job --n N [--workers W] [--depth D] [--checkpoint FILE]\n"
+        "       D is at most %d\n", JOB_MAX_DEPTH);
+}
+
+/* Counts the solutions of one board size with worker processes. The tree is cut into
+ * numbered prefix units at a fixed depth; the parent hands units to forked workers
+ * over socketpairs and appends each finished unit to the checkpoint file, flushed and
+ * synced, before handing out the next. Rerunning the same command skips every unit
+ * already in the checkpoint, so an interrupted count resumes where it stopped. Only the
+ * parent writes the checkpoint; a worker that dies is replaced and its unit handed out
+ * again, up to JOB_MAX_ATTEMPTS times before the unit is given up. */
+static int run_job(int argc, char **argv) {
+    int n = 0, worker_count = hardware_thread_count(), depth = 0;
+    const char *checkpoint_path = NULL;
+    char default_path[64];
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--job") == 0) continue;
+        if (i + 1 < argc && strcmp(argv[i], "--n") == 0) {
+            n = atoi(argv[++i]);
+        } else if (i + 1 < argc && strcmp(argv[i], "--workers") == 0) {
+            worker_count = atoi(argv[++i]);
+        } else if (i + 1 < argc && strcmp(argv[i], "--depth") == 0) {
+            depth = atoi(argv[++i]);
+        } else if (i + 1 < argc && strcmp(argv[i], "--checkpoint") == 0) {
+            checkpoint_path = argv[++i];
+        } else {
+            print_job_usage(strcmp(argv[i], "--help") == 0 ? stdout : stderr);
+            return strcmp(argv[i], "--help") == 0 ? 0 : 2;
+        }
+    }
+    if (n < 1 || n > BITBOARD_MAX_SIZE || worker_count < 1 || depth < 0 || depth > MIN(n, JOB_MAX_DEPTH)) {
+        print_job_usage(stderr);
+        return 2;
+    }
+    if (depth == 0) {
+        long long estimate = n;
+        for (depth = 1; depth < n / 2 && estimate < JOB_MIN_UNITS; depth++) estimate *= n;
+    }
+    if (!checkpoint_path) {
+        snprintf(default_path, sizeof(default_path), "nqueens-n%d.checkpoint", n);
+        checkpoint_path = default_path;
+    }
+
+    uint32_t all = (n == 32) ? UINT32_MAX : ((1u << n) - 1);
+    size_t bound = 1;
+    bool fits = true;
+    for (int d = 0; d < depth; d++) {
+        if (bound > SIZE_MAX / sizeof(PrefixTask) / n) fits = false;
+        else bound *= n;
+    }
+    PrefixTask *units = fits ? malloc(bound * sizeof(PrefixTask)) : NULL;
+    if (!units) {
+        fprintf(stderr, "not enough memory for %zu units, use a smaller --depth\n", bound);
+        return 1;
+    }
+    int unit_count = 0;
+    long long prefix_operations = 0;
+    collect_prefix_tasks(all, depth, 0, 0, 0, units, &unit_count, &prefix_operations, NULL);
+
+    bool *done = calloc(unit_count, sizeof(bool));
+    bool *running = calloc(unit_count, sizeof(bool));
+    unsigned char *attempts = calloc(unit_count, 1);
+    if (!done || !running || !attempts) {
+        fprintf(stderr, "not enough memory for %d units\n", unit_count);
+        free(units);
+        free(done);
+        free(running);
+        free(attempts);
+        return 1;
+    }
+    long long solutions = 0, operations = 0;
+    int done_count = 0;
+    int failed_count = 0;
+
+    FILE *checkpoint = fopen(checkpoint_path, "r");
+    if (checkpoint) {
+        bool matches = load_job_checkpoint(checkpoint, n, depth, unit_count, done, &solutions, &operations, &done_count);
+        fclose(checkpoint);
+        if (!matches) {
+            fprintf(stderr, "%s belongs to a different job\n", checkpoint_path);
+            free(units);
+            free(done);
+            free(running);
+            free(attempts);
+            return 1;
+        }
+    }
+    int resumed = done_count;
+
+    checkpoint = fopen(checkpoint_path, "a");
+    if (!checkpoint) {
+        perror(checkpoint_path);
+        free(units);
+        free(done);
+        free(running);
+        free(attempts);
+        return 1;
+    }
+    if (ftell(checkpoint) == 0) {
+        fprintf(checkpoint, "nqueens-job n=%d depth=%d units=%d\n", n, depth, unit_count);
+        fflush(checkpoint);
+    }
+
+    signal(SIGPIPE, SIG_IGN);
+    JobWorker *workers = calloc(worker_count, sizeof(JobWorker));
+    struct pollfd *fds = calloc(worker_count, sizeof(struct pollfd));
+    if (!workers || !fds) {
+        fprintf(stderr, "not enough memory for %d workers\n", worker_count);
+        fclose(checkpoint);
+        free(workers);
+        free(fds);
+        free(units);
+        free(done);
+        free(running);
+        free(attempts);
+        return 1;
+    }
+    int alive = 0;
+    for (int w = 0; w < worker_count; w++) {
+        workers[w].fd = -1;
+        if (job_spawn_worker(&workers[w], n)) alive++;
+    }
+
+    uint64_t start = monotonic_ns();
+    uint64_t last_report = start;
+    int next_unit = 0;
+
+    while (done_count + failed_count < unit_count && alive > 0) {
+        for (int w = 0; w < worker_count; w++) {
+            JobWorker *worker = &workers[w];
+            if (worker->fd < 0 || worker->unit >= 0) continue;
+
+            while (next_unit < unit_count
+                   && (done[next_unit] || running[next_unit] || attempts[next_unit] >= JOB_MAX_ATTEMPTS)) {
+                next_unit++;
+            }
+            if (next_unit == unit_count) break;
+            int unit = next_unit++;
+
+            JobRequest request = {unit, units[unit].rows, units[unit].ld, units[unit].rd};
+            if (write_full(worker->fd, &request, sizeof(request))) {
+                worker->unit = unit;
+                running[unit] = true;
+            } else {
+                next_unit = MIN(next_unit, unit);
+                if (!job_replace_worker(worker, n)) alive--;
+            }
+        }
+
+        for (int w = 0; w < worker_count; w++) {
+            fds[w].fd = workers[w].unit >= 0 ? workers[w].fd : -1;
+            fds[w].events = POLLIN;
+            fds[w].revents = 0;
+        }
+        if (poll(fds, worker_count, 1000) < 0 && errno != EINTR) break;
+
+        for (int w = 0; w < worker_count; w++) {
+            JobWorker *worker = &workers[w];
+            if (!fds[w].revents) continue;
+
+            JobResult result;
+            if (!read_full(worker->fd, &result, sizeof(result)) || result.unit != worker->unit) {
+                int unit = worker->unit;
+                fprintf(stderr, "worker %d failed on unit %d\n", (int)worker->pid, unit);
+                running[unit] = false;
+                if (++attempts[unit] < JOB_MAX_ATTEMPTS) {
+                    next_unit = MIN(next_unit, unit);
+                } else {
+                    fprintf(stderr, "giving up on unit %d after %d attempts\n", unit, JOB_MAX_ATTEMPTS);
+                    failed_count++;
+                }
+                if (!job_replace_worker(worker, n)) alive--;
+                continue;
+            }
+
+            fprintf(checkpoint, "%d %lld %lld\n", result.unit, (long long)result.solutions, (long long)result.operations);
+            fflush(checkpoint);
+            fsync(fileno(checkpoint));
+            done[result.unit] = true;
+            running[result.unit] = false;
+            solutions += result.solutions;
+            operations += result.operations;
+            done_count++;
+            worker->unit = -1;
+        }
+
+        if (monotonic_ns() - last_report >= 1000000000ull) {
+            fprintf(stderr, "units %d/%d, solutions so far %lld\n", done_count, unit_count, solutions);
+            last_report = monotonic_ns();
+        }
+    }
+
+    for (int w = 0; w < worker_count; w++) {
+        if (workers[w].fd >= 0) {
+            JobRequest stop = {-1, 0, 0, 0};
+            write_full(workers[w].fd, &stop, sizeof(stop));
+            close(workers[w].fd);
+        }
+        if (workers[w].pid > 0) waitpid(workers[w].pid, NULL, 0);
+    }
+    fclose(checkpoint);
+
+    bool complete = done_count == unit_count;
+    printf("{\"n\":%d,\"solutions\":%lld,\"operations\":%lld,\"units\":%d,\"done\":%d,\"resumed\":%d,\"complete\":%s,\"wall_ms\":%.3f}\n",
+           n, solutions, operations + prefix_operations, unit_count, done_count, resumed,
+           complete ? "true" : "false", (monotonic_ns() - start) / 1e6);
+
+    free(workers);
+    free(fds);
+    free(units);
+    free(done);
+    free(running);
+    free(attempts);
+    return complete ? 0 : 1;
+}
+#else
+static int run_job(int argc, char **argv) {
+    fprintf(stderr, "job mode needs a POSIX system\n");
+    return 1;
+}
+#endif
+
+int run_cli(int argc, char **argv) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--headless") == 0) return run_headless(argc, argv);
+        if (strcmp(argv[i], "--bench") == 0) return run_benchmark(argc, argv);
+        if (strcmp(argv[i], "--job") == 0) return run_job(argc, argv);
+    }
+    return -1;
+}
+
+#ifdef NQUEENS_CLI_MAIN
+/* Without a mode flag the standalone binary behaves as --headless. */
+int main(int argc, char **argv) {
+    int status = run_cli(argc, argv);
+    return status >= 0 ? status : run_headless(argc, argv);
+}
+#endif
@@ -0,0 +1,9 @@
+/* Entry point of the command-line modes shared by the GUI binary and nqueens-cli. */
+#ifndef NQUEENS_CLI_H
+#define NQUEENS_CLI_H
+
+/* Runs the mode named in argv (--headless, --bench or --job) and returns its exit
+ * status, or -1 when argv names none. */
+int run_cli(int argc, char **argv);
+
+#endif
@@ -1,12 +1,129 @@
 #include <gtk/gtk.h>
-#include <stdbool.h>
-#include <stdlib.h>
+#include "nqueens_internal.h"
+#include "cli.h"
 #include <pthread.h>
-#include <time.h>
+#include <errno.h>
+#include <math.h>
+#ifndef _WIN32
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#define UI_FRAME_INTERVAL_MS 33
+#define BOARD_MAX_CELL_PIXELS 80.0
+#define BOARD_ZOOM_STEP 1.25
+#define SOLUTION_CACHE_VERSION 1
+#define SOLUTION_CACHE_MAX_BYTES (256u << 20)
+#define SOLUTION_CACHE_MAPPINGS 16
+#define SOLUTION_CACHE_SYMMETRY_REDUCED 1u
+#define SOLUTION_HISTORY_SIZE 64
+#define ITERATOR_STEP_BUDGET (1 << 18)
+#define SOLVER_SERVICE_THREADS 3
+
+/* On-disk cache file: this header followed by stored_count n-byte placements. */
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t n;
+    char method[16];
+    uint32_t flags;
+    uint32_t reserved;
+    uint64_t solution_count;
+    uint64_t operation_count;
+    uint64_t stored_count;
+    uint64_t checksum;
+} SolutionCacheHeader;
+
+typedef struct {
+    int n;
+    int method;
+    unsigned char *mapping;
+    size_t size;
+    uint64_t last_used;
+} CachedMapping;
+
+/* The last SOLUTION_HISTORY_SIZE solutions pulled from the iterator, for "previous". */
+typedef struct {
+    unsigned char placements[SOLUTION_HISTORY_SIZE][BITBOARD_MAX_SIZE];
+    long long numbers[SOLUTION_HISTORY_SIZE];
+    int newest;
+    int count;
+    int back; /* how far behind the newest entry the board is showing */
+} SolutionHistory;
+
+/* The chessboard is a single drawing area. The cells in view are rendered into a cached
+ * surface; switching solutions repaints only the cells of columns whose queen moved,
+ * and zoom/pan re-render just the visible part of the board. */
+typedef struct {
+    GtkWidget *area;
+    cairo_surface_t *cache;
+    int cache_width;
+    int cache_height;
+    bool cache_valid;
+    int n;
+    int *rows; /* displayed row per column, -1 when the column is empty */
+    const BoardConstraints *constraints; /* pinned queens and blocked squares while editing */
+    const double *heat; /* per-column pruning share in [0, 1] while a search is traced */
+    double zoom; /* 1.0 fits the whole board in the widget */
+    double offset_x; /* board origin in widget pixels */
+    double offset_y;
+    double drag_origin_x;
+    double drag_origin_y;
+    double pointer_x;
+    double pointer_y;
+} BoardView;
+
+/* Each lane keeps only its newest request: submitting a job supersedes the one
+ * queued or running before it in the same lane. Background jobs (cache writes) are
+ * never superseded. */
+typedef enum {
+    SOLVER_LANE_SOLVE,
+    SOLVER_LANE_JUMP,
+    SOLVER_LANE_COMPLETION,
+    SOLVER_LANE_CACHE_LOAD,
+    SOLVER_LANE_BACKGROUND,
+    SOLVER_LANE_COUNT
+} SolverLane;
+
+typedef struct SolverJob SolverJob;
+
+/* A request to the solver service together with its results. The service and the UI
+ * each hold a reference, so a superseded run keeps writing into its own buffers until
+ * it notices the cancel flag, never into the request that replaced it. */
+struct SolverJob {
+    SolverLane lane;
+    void (*run)(SolverJob *job);
+    void *data; /* request and results, owned by the job */
+    void (*free_data)(void *data);
+    atomic_bool cancel; /* superseded, or cancelled by the user */
+    atomic_bool detached; /* nobody reads the results any more */
+    atomic_int refs;
+    SolverJob *next;
+};
+
+/* Long-lived worker threads fed from one FIFO of jobs. */
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    SolverJob *head;
+    SolverJob *tail;
+    SolverJob *latest[SOLVER_LANE_COUNT]; /* newest job per lane, queued or running */
+    int workers;
+} SolverService;
 
 typedef struct {
-    GtkWidget *grid;
-    GtkWidget *size_dropdown;
+    int size;
+    int method;
+    SolutionQueue queue;
+    SearchSnapshot snapshot;
+} SolveRequest;
+
+typedef struct {
+    BoardView board;
+    GtkWidget *size_spin;
     GtkWidget *generate_button;
     GtkWidget *grid_container;
     GtkWidget *prev_button;
@@ -14,300 +131,1439 @@ typedef struct {
     GtkWidget *operation_label;
     GtkWidget *solution_count_label;
     GtkWidget *method_dropdown;
+    GtkWidget *cancel_button;
+    GtkWidget *progress_label;
     GtkWidget *overlay;
+    GtkWidget *jump_spin;
     int current_size;
-    int **solutions;
-    int solution_count;
+    int current_method;
+    SolutionStore solutions;
+    SolverJob *solve_job; /* solve whose batches are being drained */
+    SolverJob *jump_job;
+    SolverJob *cache_job; /* cache file being mapped and validated */
+    guint drain_timer_id;
+    gint64 solve_start_us;
+    long long solution_count;
     int current_solution_index;
-    int operation_count;
-    pthread_t solver_thread;
-    bool thread_running;
-    bool animation_running;
+    int current_symmetry;
+    bool symmetry_reduced;
+    SolutionIndex index;
+    SolutionIterator iterator;
+    SolutionHistory history;
+    GtkWidget *lazy_check;
+    GtkWidget *edit_check;
+    bool editing;
+    BoardConstraints constraints;
+    SolverJob *completion_job; /* newest completion request, NULL once answered */
+    bool lazy_browsing;
+    guint iterator_idle_id;
+    bool indexed_browsing;
+    long long current_rank;
+    long long operation_count;
+    SolverStats stats;
+    GtkWidget *stats_label;
+    GtkWidget *stats_export_label;
+    bool animation_running; /* the board shows the running search, not a solution */
     guint animation_timer_id;
+    double search_heat[BITBOARD_MAX_SIZE];
 } GridData;
 
 typedef struct {
     GridData *grid_data;
-    int size;
-    int method;
-} ThreadData;
+    BoardConstraints constraints;
+    bool found;
+    long long nodes;
+    uint64_t elapsed_ns;
+    unsigned char placement[BITBOARD_MAX_SIZE];
+} CompletionData;
 
-bool is_safe(int **board, int row, int col, int n) {
-    for (int i = 0; i < col; i++) {
-        if (board[row][i]) return false;
-    }
-    for (int i = row, j = col; i >= 0 && j >= 0; i--, j--) {
-        if (board[i][j]) return false;
-    }
-    for (int i = row, j = col; i < n && j >= 0; i++, j--) {
-        if (board[i][j]) return false;
+typedef struct {
+    GridData *grid_data;
+    SolutionIndex *index;
+    long long rank;
+    long long total;
+    bool found;
+    unsigned char placement[BITBOARD_MAX_SIZE];
+} JumpData;
+
+typedef struct {
+    GridData *grid_data;
+    int n;
+    SolverMethod method;
+    unsigned char *mapping; /* validated file, NULL when there is none */
+    size_t size;
+} CacheLoad;
+
+/* A finished run on its way to disk. The store's arena is lent to the job and handed
+ * back once the file is written. */
+typedef struct {
+    GridData *grid_data;
+    int n;
+    SolverMethod method;
+    uint32_t flags;
+    long long solutions;
+    long long operations;
+    unsigned char *data;
+    size_t capacity;
+    size_t count;
+    size_t stride;
+} CacheSave;
+
+static void current_placement(GridData *grid_data, unsigned char *placement) {
+    const unsigned char *stored = solution_store_get(&grid_data->solutions, grid_data->current_solution_index);
+    transform_placement(stored, placement, grid_data->current_size, grid_data->current_symmetry);
+}
+
+/* Symmetry-reduced runs store one placement per class; browsing walks the distinct
+ * images of each stored placement before moving to the next one. */
+static void step_symmetric_solution(GridData *grid_data, int direction) {
+    int n = grid_data->current_size;
+    unsigned char fundamental[BITBOARD_MAX_SIZE];
+    int count = (int)grid_data->solutions.count;
+
+    int symmetry = grid_data->current_symmetry;
+    grid_data->current_symmetry = 0;
+    current_placement(grid_data, fundamental);
+
+    for (;;) {
+        symmetry += direction;
+        if (symmetry < 0 || symmetry > 7) {
+            grid_data->current_solution_index = (grid_data->current_solution_index + direction + count) % count;
+            grid_data->current_symmetry = 0;
+            current_placement(grid_data, fundamental);
+            symmetry = (direction > 0) ? 0 : 7;
+        }
+        if (is_distinct_image(fundamental, n, symmetry)) break;
     }
-    return true;
+    grid_data->current_symmetry = symmetry;
 }
 
-bool is_configuration_valid(int **board, int n) {
-    for (int col = 0; col < n; col++) {
-        for (int row = 0; row < n; row++) {
-            if (board[row][col] == 1) {
-                for (int i = 0; i < n; i++) {
-                    if (i != col && board[row][i] == 1) return false;
-                    if (i != row && board[i][col] == 1) return false;
-                }
-                for (int i = 1; i < n; i++) {
-                    if (row + i < n && col + i < n && board[row + i][col + i] == 1) return false;
-                    if (row - i >= 0 && col - i >= 0 && board[row - i][col - i] == 1) return false;
-                    if (row + i < n && col - i >= 0 && board[row + i][col - i] == 1) return false;
-                    if (row - i >= 0 && col + i < n && board[row - i][col + i] == 1) return false;
-                }
+static double board_view_cell_size(const BoardView *view) {
+    int side = MIN(gtk_widget_get_width(view->area), gtk_widget_get_height(view->area));
+    return view->n > 0 ? side * view->zoom / view->n : 0.0;
+}
+
+/* Centres the board along an axis where it fits, otherwise keeps the view inside it. */
+static void board_view_clamp(BoardView *view) {
+    double board = board_view_cell_size(view) * view->n;
+    int width = gtk_widget_get_width(view->area);
+    int height = gtk_widget_get_height(view->area);
+
+    if (board <= width) view->offset_x = (width - board) / 2;
+    else view->offset_x = CLAMP(view->offset_x, width - board, 0.0);
+    if (board <= height) view->offset_y = (height - board) / 2;
+    else view->offset_y = CLAMP(view->offset_y, height - board, 0.0);
+}
+
+static void board_view_invalidate(BoardView *view) {
+    view->cache_valid = false;
+    gtk_widget_queue_draw(view->area);
+}
+
+/* Adds one cell to the current path; cells of 4 px and more keep a 1 px grid line,
+ * smaller ones are drawn at least a pixel wide so far zoomed-out queens stay visible. */
+static void board_view_cell_path(const BoardView *view, cairo_t *cr, double cell, int col, int row) {
+    double gap = cell >= 4.0 ? 1.0 : 0.0;
+    double side = MAX(cell - gap, 1.0);
+    cairo_rectangle(cr, view->offset_x + col * cell + gap, view->offset_y + row * cell + gap, side, side);
+}
+
+static void board_view_visible_range(const BoardView *view, double cell, double offset, int extent, int *first, int *last) {
+    *first = MAX(0, (int)floor(-offset / cell));
+    *last = MIN(view->n, (int)ceil((extent - offset) / cell));
+}
+
+/* Renders the visible part of the board into the cache: cost follows the cells on
+ * screen, not n², and the queens are one filled path. */
+static void board_view_render(BoardView *view) {
+    cairo_t *cr = cairo_create(view->cache);
+    cairo_set_operator(cr, CAIRO_OPERATOR_SOURCE);
+    cairo_set_source_rgba(cr, 0, 0, 0, 0);
+    cairo_paint(cr);
+    cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+    view->cache_valid = true;
+    if (view->n == 0) {
+        cairo_destroy(cr);
+        return;
+    }
+
+    board_view_clamp(view);
+    double cell = board_view_cell_size(view);
+    int first_col, last_col, first_row, last_row;
+    board_view_visible_range(view, cell, view->offset_x, view->cache_width, &first_col, &last_col);
+    board_view_visible_range(view, cell, view->offset_y, view->cache_height, &first_row, &last_row);
+
+    cairo_rectangle(cr, view->offset_x + first_col * cell, view->offset_y + first_row * cell,
+                    (last_col - first_col) * cell, (last_row - first_row) * cell);
+    if (cell >= 4.0) {
+        cairo_set_source_rgb(cr, 0.55, 0.55, 0.70);
+        cairo_fill(cr);
+        for (int col = first_col; col < last_col; col++) {
+            for (int row = first_row; row < last_row; row++) {
+                board_view_cell_path(view, cr, cell, col, row);
             }
         }
     }
-    return true;
-}
+    cairo_set_source_rgb(cr, 0.90, 0.90, 0.98);
+    cairo_fill(cr);
+
+    if (view->heat) {
+        for (int col = first_col; col < last_col; col++) {
+            if (view->heat[col] <= 0) continue;
+            cairo_rectangle(cr, view->offset_x + col * cell, view->offset_y + first_row * cell,
+                            cell, (last_row - first_row) * cell);
+            cairo_set_source_rgba(cr, 0.85, 0.30, 0.10, 0.6 * view->heat[col]);
+            cairo_fill(cr);
+        }
+    }
 
-void generate_all_configurations(int **board, int col, int n, int *operation_count, int **solutions, int *solution_count) {
-    if (col == n) {
-        (*operation_count)++;
-        if (is_configuration_valid(board, n)) {
-            for (int i = 0; i < n; i++) {
-                for (int j = 0; j < n; j++) {
-                    solutions[*solution_count][i * n + j] = board[i][j];
-                }
+    const BoardConstraints *constraints = view->constraints;
+    if (constraints) {
+        for (int col = first_col; col < last_col; col++) {
+            for (int row = first_row; row < last_row; row++) {
+                if (constraints->blocked[col] & (1u << row)) board_view_cell_path(view, cr, cell, col, row);
             }
-            (*solution_count)++;
         }
-        return;
+        cairo_set_source_rgb(cr, 0.55, 0.20, 0.20);
+        cairo_fill(cr);
     }
 
-    for (int row = 0; row < n; row++) {
-        board[row][col] = 1;
-        generate_all_configurations(board, col + 1, n, operation_count, solutions, solution_count);
-        board[row][col] = 0;
+    for (int col = first_col; col < last_col; col++) {
+        int row = view->rows[col];
+        bool pinned = constraints && constraints->pinned[col] == row;
+        if (row >= first_row && row < last_row && !pinned) board_view_cell_path(view, cr, cell, col, row);
     }
-}
+    cairo_set_source_rgb(cr, 0, 0, 0);
+    cairo_fill(cr);
 
-bool solve_n_queens_intuitive(int **board, int col, int n, int *operation_count) {
-    if (col == n) return true;
-    for (int i = 0; i < n; i++) {
-        (*operation_count)++;
-        if (is_safe(board, i, col, n)) {
-            board[i][col] = 1;
-            if (solve_n_queens_intuitive(board, col + 1, n, operation_count)) {
-                return true;
-            }
-            board[i][col] = 0;
+    if (constraints) {
+        for (int col = first_col; col < last_col; col++) {
+            int row = constraints->pinned[col];
+            if (row >= first_row && row < last_row) board_view_cell_path(view, cr, cell, col, row);
         }
+        cairo_set_source_rgb(cr, 0.83, 0.69, 0.22);
+        cairo_fill(cr);
     }
-    return false;
+    cairo_destroy(cr);
 }
 
-bool solve_n_queens_arborescent(int **board, int col, int n, int *operation_count, int **solutions, int *solution_count) {
-    if (col == n) {
-        (*operation_count)++;
-        if (is_configuration_valid(board, n)) {
-            for (int i = 0; i < n; i++) {
-                for (int j = 0; j < n; j++) {
-                    solutions[0][i * n + j] = board[i][j];
-                }
-            }
-            *solution_count = 1;
-            return true;
-        }
-        return false;
+static void board_view_draw(GtkDrawingArea *area, cairo_t *cr, int width, int height, gpointer data) {
+    BoardView *view = data;
+    if (!view->cache || width != view->cache_width || height != view->cache_height) {
+        if (view->cache) cairo_surface_destroy(view->cache);
+        view->cache = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+        view->cache_width = width;
+        view->cache_height = height;
+        view->cache_valid = false;
     }
+    if (!view->cache_valid) board_view_render(view);
 
-    for (int row = 0; row < n; row++) {
-        board[row][col] = 1;
-        if (solve_n_queens_arborescent(board, col + 1, n, operation_count, solutions, solution_count)) {
-            return true;
-        }
-        board[row][col] = 0;
+    cairo_set_source_surface(cr, view->cache, 0, 0);
+    cairo_paint(cr);
+}
+
+/* Starts a batch of queen moves; paints go straight into the cache when it is valid,
+ * otherwise the next draw renders the board from view->rows anyway. */
+static cairo_t *board_view_begin(BoardView *view) {
+    return view->cache_valid ? cairo_create(view->cache) : NULL;
+}
+
+static void board_view_move_queen(BoardView *view, cairo_t *cr, int col, int row) {
+    int previous = view->rows[col];
+    if (previous == row) return;
+    view->rows[col] = row;
+    if (!cr) return;
+
+    double cell = board_view_cell_size(view);
+    if (previous >= 0) {
+        board_view_cell_path(view, cr, cell, col, previous);
+        cairo_set_source_rgb(cr, 0.90, 0.90, 0.98);
+        cairo_fill(cr);
+    }
+    if (row >= 0) {
+        board_view_cell_path(view, cr, cell, col, row);
+        if (view->constraints && view->constraints->pinned[col] == row) cairo_set_source_rgb(cr, 0.83, 0.69, 0.22);
+        else cairo_set_source_rgb(cr, 0, 0, 0);
+        cairo_fill(cr);
     }
-    return false;
+}
+
+/* Maps a widget point to the board square under it; false outside the board. */
+static bool board_view_cell_at(const BoardView *view, double x, double y, int *col, int *row) {
+    double cell = board_view_cell_size(view);
+    if (view->n == 0 || cell <= 0) return false;
+    *col = (int)floor((x - view->offset_x) / cell);
+    *row = (int)floor((y - view->offset_y) / cell);
+    return *col >= 0 && *col < view->n && *row >= 0 && *row < view->n;
+}
+
+static void board_view_end(BoardView *view, cairo_t *cr) {
+    if (cr) cairo_destroy(cr);
+    gtk_widget_queue_draw(view->area);
+}
+
+/* Clears the board for a new size and resets the view to fit it. */
+static void board_view_reset(BoardView *view, int n) {
+    int *rows = realloc(view->rows, (size_t)n * sizeof(int));
+    if (!rows) n = 0;
+    else view->rows = rows;
+    for (int col = 0; col < n; col++) view->rows[col] = -1;
+    view->n = n;
+    view->zoom = 1.0;
+    board_view_invalidate(view);
+}
+
+static void board_view_motion(GtkEventControllerMotion *controller, double x, double y, gpointer data) {
+    BoardView *view = data;
+    view->pointer_x = x;
+    view->pointer_y = y;
+}
+
+/* Scrolling zooms around the pointer, from fitting the window up to
+ * BOARD_MAX_CELL_PIXELS per cell. */
+static gboolean board_view_scroll(GtkEventControllerScroll *controller, double dx, double dy, gpointer data) {
+    BoardView *view = data;
+    if (view->n == 0 || dy == 0) return FALSE;
+
+    double old_cell = board_view_cell_size(view);
+    double max_zoom = MAX(1.0, view->zoom * BOARD_MAX_CELL_PIXELS / old_cell);
+    view->zoom = CLAMP(dy < 0 ? view->zoom * BOARD_ZOOM_STEP : view->zoom / BOARD_ZOOM_STEP, 1.0, max_zoom);
+
+    double scale = board_view_cell_size(view) / old_cell;
+    view->offset_x = view->pointer_x - (view->pointer_x - view->offset_x) * scale;
+    view->offset_y = view->pointer_y - (view->pointer_y - view->offset_y) * scale;
+    board_view_invalidate(view);
+    return TRUE;
+}
+
+static void board_view_drag_begin(GtkGestureDrag *gesture, double x, double y, gpointer data) {
+    BoardView *view = data;
+    view->drag_origin_x = view->offset_x;
+    view->drag_origin_y = view->offset_y;
+}
+
+static void board_view_drag_update(GtkGestureDrag *gesture, double dx, double dy, gpointer data) {
+    BoardView *view = data;
+    view->offset_x = view->drag_origin_x + dx;
+    view->offset_y = view->drag_origin_y + dy;
+    board_view_invalidate(view);
+}
+
+static void board_view_attach(BoardView *view, GtkWidget *area) {
+    *view = (BoardView){0};
+    view->area = area;
+    view->zoom = 1.0;
+    gtk_drawing_area_set_draw_func(GTK_DRAWING_AREA(area), board_view_draw, view, NULL);
+
+    GtkEventController *motion = gtk_event_controller_motion_new();
+    g_signal_connect(motion, "motion", G_CALLBACK(board_view_motion), view);
+    gtk_widget_add_controller(area, motion);
+
+    GtkEventController *scroll = gtk_event_controller_scroll_new(GTK_EVENT_CONTROLLER_SCROLL_VERTICAL);
+    g_signal_connect(scroll, "scroll", G_CALLBACK(board_view_scroll), view);
+    gtk_widget_add_controller(area, scroll);
+
+    GtkGesture *drag = gtk_gesture_drag_new();
+    g_signal_connect(drag, "drag-begin", G_CALLBACK(board_view_drag_begin), view);
+    g_signal_connect(drag, "drag-update", G_CALLBACK(board_view_drag_update), view);
+    gtk_widget_add_controller(area, GTK_EVENT_CONTROLLER(drag));
 }
 
 static void update_grid_display(GridData *grid_data) {
-    for (int i = 0; i < grid_data->current_size; i++) {
-        for (int j = 0; j < grid_data->current_size; j++) {
-            GtkWidget *cell = gtk_grid_get_child_at(GTK_GRID(grid_data->grid), j, i);
-            if (cell) {
-                if (grid_data->solutions[grid_data->current_solution_index][i * grid_data->current_size + j]) {
-                    gtk_widget_set_name(cell, "queen-cell");
-                } else {
-                    gtk_widget_set_name(cell, "grid-cell");
-                }
-            }
+    BoardView *view = &grid_data->board;
+    cairo_t *cr = board_view_begin(view);
+
+    if (grid_data->symmetry_reduced) {
+        unsigned char placement[BITBOARD_MAX_SIZE];
+        current_placement(grid_data, placement);
+        for (int col = 0; col < view->n; col++) board_view_move_queen(view, cr, col, placement[col]);
+    } else {
+        for (int col = 0; col < view->n; col++) {
+            board_view_move_queen(view, cr, col, solution_store_row(&grid_data->solutions, grid_data->current_solution_index, col));
         }
     }
+    board_view_end(view, cr);
 }
 
-static gboolean random_grid_animation(gpointer data) {
+/* Shows the partial board from the solver's latest snapshot. Column c is tinted by the
+ * share of its candidates the search cut: each node in column c - 1 leaves n - c rows
+ * free in column c, and nodes[c] of those became queens. */
+static gboolean search_trace_animation(gpointer data) {
     GridData *grid_data = (GridData *)data;
 
     if (!grid_data->animation_running) {
         return G_SOURCE_REMOVE;
     }
 
-    int row = rand() % grid_data->current_size;
-    int col = rand() % grid_data->current_size;
+    BoardView *view = &grid_data->board;
+    SolverJob *job = grid_data->solve_job;
+    if (!job || view->n == 0 || view->n > BITBOARD_MAX_SIZE) {
+        return G_SOURCE_CONTINUE;
+    }
+
+    SolveRequest *request = job->data;
+    SearchFrame frame;
+    if (request->size != view->n || !search_snapshot_read(&request->snapshot, &frame)) {
+        return G_SOURCE_CONTINUE;
+    }
 
-    GtkWidget *cell = gtk_grid_get_child_at(GTK_GRID(grid_data->grid), col, row);
+    int n = view->n;
+    for (int col = 0; col < n; col++) {
+        view->rows[col] = col < frame.depth ? frame.placement[col] : -1;
+        double candidates = col > 0 ? (double)frame.nodes[col - 1] * (n - col) : 0.0;
+        grid_data->search_heat[col] = candidates > 0 ? CLAMP(1.0 - frame.nodes[col] / candidates, 0.0, 1.0) : 0.0;
+    }
+    view->heat = grid_data->search_heat;
+    board_view_invalidate(view);
+
+    return G_SOURCE_CONTINUE;
+}
+
+static SolverService solver_service = {.lock = PTHREAD_MUTEX_INITIALIZER, .wake = PTHREAD_COND_INITIALIZER};
+
+static SolverJob *solver_job_new(SolverLane lane, void (*run)(SolverJob *), void *data, void (*free_data)(void *)) {
+    SolverJob *job = calloc(1, sizeof(SolverJob));
+    job->lane = lane;
+    job->run = run;
+    job->data = data;
+    job->free_data = free_data;
+    atomic_init(&job->cancel, false);
+    atomic_init(&job->detached, false);
+    atomic_init(&job->refs, 1);
+    return job;
+}
+
+static void solver_job_retain(SolverJob *job) {
+    atomic_fetch_add_explicit(&job->refs, 1, memory_order_relaxed);
+}
+
+static void solver_job_release(SolverJob *job) {
+    if (atomic_fetch_sub_explicit(&job->refs, 1, memory_order_acq_rel) != 1) return;
+    if (job->free_data) job->free_data(job->data);
+    free(job);
+}
 
-    if (cell == NULL) {
+/* Drops the caller's interest in a job: it is cancelled, told nobody is listening,
+ * and released. */
+static void solver_job_abandon(SolverJob *job) {
+    atomic_store(&job->detached, true);
+    atomic_store(&job->cancel, true);
+    solver_job_release(job);
+}
+
+static void* solver_service_worker(void *arg) {
+    SolverService *service = arg;
+    for (;;) {
+        pthread_mutex_lock(&service->lock);
+        while (!service->head) pthread_cond_wait(&service->wake, &service->lock);
+        SolverJob *job = service->head;
+        service->head = job->next;
+        if (!service->head) service->tail = NULL;
+        pthread_mutex_unlock(&service->lock);
+
+        job->run(job);
+
+        pthread_mutex_lock(&service->lock);
+        if (service->latest[job->lane] == job) service->latest[job->lane] = NULL;
+        pthread_mutex_unlock(&service->lock);
+        solver_job_release(job);
+    }
+    return NULL;
+}
+
+/* Queues a job for the worker pool, which is started on first use; workers that could
+ * not be created are retried on the next submit. The previous job of the same lane is
+ * cancelled; if no worker has picked it up yet it is dropped without running, so a
+ * burst of requests computes only the last one. */
+static void solver_service_submit(SolverJob *job) {
+    SolverService *service = &solver_service;
+    solver_job_retain(job);
+
+    pthread_mutex_lock(&service->lock);
+    for (int i = service->workers; i < SOLVER_SERVICE_THREADS; i++) {
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, solver_service_worker, service) != 0) break;
+        pthread_detach(thread);
+        service->workers++;
+    }
+
+    SolverJob *previous = job->lane == SOLVER_LANE_BACKGROUND ? NULL : service->latest[job->lane];
+    SolverJob *dropped = NULL;
+    if (previous) {
+        atomic_store(&previous->detached, true);
+        atomic_store(&previous->cancel, true);
+        for (SolverJob **link = &service->head, *tail = NULL; *link; tail = *link, link = &(*link)->next) {
+            if (*link != previous) continue;
+            *link = previous->next;
+            if (service->tail == previous) service->tail = tail;
+            dropped = previous;
+            break;
+        }
+    }
+    service->latest[job->lane] = job;
+
+    job->next = NULL;
+    if (service->tail) service->tail->next = job;
+    else service->head = job;
+    service->tail = job;
+    pthread_cond_signal(&service->wake);
+    pthread_mutex_unlock(&service->lock);
+
+    if (dropped) solver_job_release(dropped);
+}
+
+/* Solved boards are kept on disk under $XDG_CACHE_HOME/les-8-reines (or ~/.cache) as one
+ * file per size and method, and memory-mapped when asked for again. Mappings stay open
+ * for the life of the process, so a repeated request is a table lookup. */
+static CachedMapping cache_mappings[SOLUTION_CACHE_MAPPINGS];
+static uint64_t cache_clock;
+
+static bool method_is_cacheable(SolverMethod method, int n) {
+    return method != METHOD_MIN_CONFLICTS && n >= 1 && n <= BITBOARD_MAX_SIZE;
+}
+
+static uint64_t fnv1a(const unsigned char *data, size_t size) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+#ifndef _WIN32
+static bool solution_cache_dir(char *dir, size_t size) {
+    const char *base = getenv("XDG_CACHE_HOME");
+    char fallback[PATH_MAX];
+    if (!base || !*base) {
+        const char *home = getenv("HOME");
+        if (!home) return false;
+        snprintf(fallback, sizeof(fallback), "%s/.cache", home);
+        base = fallback;
+    }
+    mkdir(base, 0755);
+    if (snprintf(dir, size, "%s/les-8-reines", base) >= (int)size) return false;
+    return mkdir(dir, 0755) == 0 || errno == EEXIST;
+}
+
+static bool solution_cache_path(int n, SolverMethod method, char *path, size_t size) {
+    char dir[PATH_MAX];
+    if (!solution_cache_dir(dir, sizeof(dir))) return false;
+    return snprintf(path, size, "%s/n%02d-%s.nqc", dir, n, method_names[method]) < (int)size;
+}
+
+static bool solution_cache_valid(const unsigned char *mapping, size_t size, int n, SolverMethod method) {
+    if (size < sizeof(SolutionCacheHeader)) return false;
+    const SolutionCacheHeader *header = (const SolutionCacheHeader *)mapping;
+    if (memcmp(header->magic, "NQCACHE", 8) != 0 || header->version != SOLUTION_CACHE_VERSION) return false;
+    if (header->n != (uint32_t)n || strncmp(header->method, method_names[method], sizeof(header->method)) != 0) return false;
+    if (header->stored_count > (size - sizeof(SolutionCacheHeader)) / n) return false;
+    if (size != sizeof(SolutionCacheHeader) + header->stored_count * n) return false;
+    return fnv1a(mapping + sizeof(SolutionCacheHeader), size - sizeof(SolutionCacheHeader)) == header->checksum;
+}
+
+/* Returns the cached run for (n, method) if it is already mapped. Main thread only. */
+static const SolutionCacheHeader *solution_cache_find(int n, SolverMethod method) {
+    for (int i = 0; i < SOLUTION_CACHE_MAPPINGS; i++) {
+        CachedMapping *entry = &cache_mappings[i];
+        if (entry->mapping && entry->n == n && entry->method == (int)method) {
+            entry->last_used = ++cache_clock;
+            return (const SolutionCacheHeader *)entry->mapping;
+        }
+    }
+    return NULL;
+}
+
+/* Maps and validates the cache file for (n, method); files that fail validation are
+ * removed. Hashes the whole file, so it runs on the solver service. */
+static unsigned char *solution_cache_map(int n, SolverMethod method, size_t *size) {
+    char path[PATH_MAX];
+    if (!solution_cache_path(n, method, path, sizeof(path))) return NULL;
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
+
+    struct stat info;
+    unsigned char *mapping = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        mapping = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    if (mapping != MAP_FAILED && !solution_cache_valid(mapping, info.st_size, n, method)) {
+        munmap(mapping, info.st_size);
+        mapping = MAP_FAILED;
+        unlink(path);
+    }
+    if (mapping != MAP_FAILED) futimens(fd, NULL);
+    close(fd);
+    if (mapping == MAP_FAILED) return NULL;
+
+    *size = info.st_size;
+    return mapping;
+}
+
+static void solution_cache_unmap(unsigned char *mapping, size_t size) {
+    munmap(mapping, size);
+}
+
+/* Keeps a validated mapping for the life of the process. Callers reset the store
+ * first, so no mapping is borrowed when the least recently used one is unmapped to
+ * make room. Main thread only. */
+static const SolutionCacheHeader *solution_cache_install(int n, SolverMethod method, unsigned char *mapping, size_t size) {
+    CachedMapping *slot = &cache_mappings[0];
+    for (int i = 1; i < SOLUTION_CACHE_MAPPINGS && slot->mapping; i++) {
+        CachedMapping *entry = &cache_mappings[i];
+        if (!entry->mapping || entry->last_used < slot->last_used) slot = entry;
+    }
+    if (slot->mapping) munmap(slot->mapping, slot->size);
+    *slot = (CachedMapping){n, method, mapping, size, ++cache_clock};
+    return (const SolutionCacheHeader *)mapping;
+}
+
+/* Deletes the least recently used cache files until the directory fits the size limit. */
+static void solution_cache_evict(const char *dir) {
+    for (;;) {
+        DIR *listing = opendir(dir);
+        if (!listing) return;
+
+        uint64_t total = 0;
+        time_t oldest_time = 0;
+        char oldest[PATH_MAX] = "";
+        struct dirent *entry;
+        while ((entry = readdir(listing)) != NULL) {
+            size_t length = strlen(entry->d_name);
+            if (length < 4 || strcmp(entry->d_name + length - 4, ".nqc") != 0) continue;
+
+            char path[PATH_MAX];
+            struct stat info;
+            if (snprintf(path, sizeof(path), "%s/%s", dir, entry->d_name) >= (int)sizeof(path)) continue;
+            if (stat(path, &info) != 0) continue;
+            total += info.st_size;
+            if (!oldest[0] || info.st_mtime < oldest_time) {
+                oldest_time = info.st_mtime;
+                snprintf(oldest, sizeof(oldest), "%s", path);
+            }
+        }
+        closedir(listing);
+
+        if (total <= SOLUTION_CACHE_MAX_BYTES || !oldest[0] || unlink(oldest) != 0) return;
+    }
+}
+
+/* Writes a finished run to the cache through a temporary file and rename, so readers
+ * never map a partial file, then trims the directory. Runs on the solver service;
+ * saves are serialised so two runs of the same size never share the temporary file. */
+static void solution_cache_save(const CacheSave *save) {
+    static pthread_mutex_t save_lock = PTHREAD_MUTEX_INITIALIZER;
+    int n = save->n;
+    SolverMethod method = save->method;
+
+    char path[PATH_MAX], temp[PATH_MAX + 8];
+    if (!solution_cache_path(n, method, path, sizeof(path))) return;
+    snprintf(temp, sizeof(temp), "%s.tmp", path);
+
+    size_t bytes = save->count * save->stride;
+    SolutionCacheHeader header = {0};
+    memcpy(header.magic, "NQCACHE", 8);
+    header.version = SOLUTION_CACHE_VERSION;
+    header.n = n;
+    snprintf(header.method, sizeof(header.method), "%s", method_names[method]);
+    header.flags = save->flags;
+    header.solution_count = save->solutions;
+    header.operation_count = save->operations;
+    header.stored_count = save->count;
+    header.checksum = fnv1a(save->data, bytes);
+
+    pthread_mutex_lock(&save_lock);
+    FILE *file = fopen(temp, "wb");
+    bool written = file && fwrite(&header, sizeof(header), 1, file) == 1
+        && (bytes == 0 || fwrite(save->data, bytes, 1, file) == 1);
+    if (file) written = (fclose(file) == 0) && written;
+    if (written && rename(temp, path) == 0) {
+        char dir[PATH_MAX];
+        if (solution_cache_dir(dir, sizeof(dir))) solution_cache_evict(dir);
+    } else if (file) {
+        unlink(temp);
+    }
+    pthread_mutex_unlock(&save_lock);
+}
+#else
+static const SolutionCacheHeader *solution_cache_find(int n, SolverMethod method) {
+    return NULL;
+}
+
+static unsigned char *solution_cache_map(int n, SolverMethod method, size_t *size) {
+    return NULL;
+}
+
+static void solution_cache_unmap(unsigned char *mapping, size_t size) {
+}
+
+static const SolutionCacheHeader *solution_cache_install(int n, SolverMethod method, unsigned char *mapping, size_t size) {
+    return NULL;
+}
+
+static void solution_cache_save(const CacheSave *save) {
+}
+#endif
+
+/* Fills the stats panel from the last published snapshot. Runs without search
+ * statistics (cache hits, on-demand browsing) show the totals only. */
+static void update_stats_label(GridData *grid_data) {
+    const SolverStats *stats = &grid_data->stats;
+    GString *text = g_string_new(NULL);
+    g_string_append_printf(text, "Préparation: %.2f ms   Recherche: %.2f ms   Publication: %.2f ms\n",
+                           stats->phase_ns[SOLVER_PHASE_SETUP] / 1e6, stats->phase_ns[SOLVER_PHASE_SEARCH] / 1e6,
+                           stats->phase_ns[SOLVER_PHASE_PUBLISH] / 1e6);
+    g_string_append_printf(text, "Feuilles validées: %lld   Branches élaguées: %lld   Solutions: %lld",
+                           stats->leaves, stats->pruned, grid_data->solution_count);
+    if (stats->updates > 0) g_string_append_printf(text, "   Mises à jour de liens: %lld", stats->updates);
+
+    int columns = MIN(grid_data->current_size, BITBOARD_MAX_SIZE);
+    for (int c = 0; c < columns; c++) {
+        if (stats->nodes[c] == 0) continue;
+        g_string_append_printf(text, "%sColonne %2d: %lld nœuds", c % 4 ? "   " : "\n", c, stats->nodes[c]);
+    }
+    gtk_label_set_text(GTK_LABEL(grid_data->stats_label), text->str);
+    g_string_free(text, TRUE);
+}
+
+static void update_counter_labels(GridData *grid_data) {
+    char operation_text[50];
+    snprintf(operation_text, sizeof(operation_text), "Operations: %lld", grid_data->operation_count);
+    gtk_label_set_text(GTK_LABEL(grid_data->operation_label), operation_text);
+
+    char solution_count_text[50];
+    snprintf(solution_count_text, sizeof(solution_count_text), "Solutions: %lld", grid_data->solution_count);
+    gtk_label_set_text(GTK_LABEL(grid_data->solution_count_label), solution_count_text);
+    update_stats_label(grid_data);
+}
+
+/* Writes the current statistics next to the user's documents as CSV or JSON. */
+static void export_stats(GridData *grid_data, bool json) {
+    const char *dir = g_get_user_special_dir(G_USER_DIRECTORY_DOCUMENTS);
+    if (!dir) dir = g_get_home_dir();
+
+    char name[96];
+    snprintf(name, sizeof(name), "les-8-reines-stats-n%d-%s.%s", grid_data->current_size,
+             method_names[grid_data->current_method], json ? "json" : "csv");
+    char *path = g_build_filename(dir, name, NULL);
+
+    char message[512];
+    FILE *file = fopen(path, "w");
+    if (!file) {
+        snprintf(message, sizeof(message), "Export impossible: %s", strerror(errno));
+    } else {
+        if (json) {
+            fprintf(file, "{\"n\":%d,\"method\":\"%s\",\"operations\":%lld,\"stats\":",
+                    grid_data->current_size, method_names[grid_data->current_method], grid_data->operation_count);
+            write_stats_json(file, &grid_data->stats, grid_data->current_size);
+            fputs("}\n", file);
+        } else {
+            write_stats_csv(file, &grid_data->stats, grid_data->current_size);
+        }
+        bool ok = fclose(file) == 0;
+        snprintf(message, sizeof(message), ok ? "Exporté vers %s" : "Export impossible: %s", ok ? path : strerror(errno));
+    }
+    gtk_label_set_text(GTK_LABEL(grid_data->stats_export_label), message);
+    g_free(path);
+}
+
+static void export_stats_csv(GtkWidget *widget, gpointer data) {
+    export_stats((GridData *)data, false);
+}
+
+static void export_stats_json(GtkWidget *widget, gpointer data) {
+    export_stats((GridData *)data, true);
+}
+
+/* Shows the completed fraction and a remaining-time estimate extrapolated from the
+ * elapsed time; progress < 0 means no new batch arrived this frame. */
+static void update_progress_label(GridData *grid_data, double progress, bool finished, bool cancelled) {
+    double elapsed = (g_get_monotonic_time() - grid_data->solve_start_us) / 1e6;
+    char progress_text[100];
+
+    if (cancelled) {
+        snprintf(progress_text, sizeof(progress_text), "Recherche annulée après %.1f s", elapsed);
+    } else if (finished) {
+        snprintf(progress_text, sizeof(progress_text), "Terminé en %.2f s", elapsed);
+    } else if (progress < 0) {
+        return;
+    } else if (progress > 0.0 && elapsed >= 0.5) {
+        snprintf(progress_text, sizeof(progress_text), "Progression: %.1f %% - reste ~%.0f s",
+                 progress * 100.0, elapsed * (1.0 - progress) / progress);
+    } else {
+        snprintf(progress_text, sizeof(progress_text), "Progression: %.1f %%", progress * 100.0);
+    }
+    gtk_label_set_text(GTK_LABEL(grid_data->progress_label), progress_text);
+}
+
+static void show_history_entry(GridData *grid_data) {
+    SolutionHistory *history = &grid_data->history;
+    int slot = (history->newest - history->back + SOLUTION_HISTORY_SIZE) % SOLUTION_HISTORY_SIZE;
+
+    BoardView *view = &grid_data->board;
+    cairo_t *cr = board_view_begin(view);
+    for (int col = 0; col < view->n; col++) board_view_move_queen(view, cr, col, history->placements[slot][col]);
+    board_view_end(view, cr);
+
+    char progress_text[100];
+    snprintf(progress_text, sizeof(progress_text), "Solution n°%lld", history->numbers[slot]);
+    gtk_label_set_text(GTK_LABEL(grid_data->progress_label), progress_text);
+}
+
+static bool solver_busy(const GridData *grid_data) {
+    return grid_data->solve_job || grid_data->jump_job || grid_data->cache_job;
+}
+
+static void stop_iterator(GridData *grid_data) {
+    if (grid_data->iterator_idle_id > 0) {
+        g_source_remove(grid_data->iterator_idle_id);
+        grid_data->iterator_idle_id = 0;
+    }
+}
+
+/* Idle handler for on-demand browsing: advances the iterator by at most
+ * ITERATOR_STEP_BUDGET nodes per main-loop pass, so a long gap between two solutions
+ * never blocks the UI, and stops as soon as one more solution is found. */
+static gboolean pull_next_solution(gpointer data) {
+    GridData *grid_data = (GridData *)data;
+    SolutionIterator *it = &grid_data->iterator;
+    SolutionHistory *history = &grid_data->history;
+    unsigned char placement[BITBOARD_MAX_SIZE];
+
+    IteratorStatus status = solution_iterator_next(it, placement, ITERATOR_STEP_BUDGET);
+    grid_data->operation_count = it->operations;
+    if (status == ITERATOR_PAUSED) {
+        update_counter_labels(grid_data);
         return G_SOURCE_CONTINUE;
     }
 
-    if (strcmp(gtk_widget_get_name(cell), "queen-cell") == 0) {
-        gtk_widget_set_name(cell, "grid-cell");
+    grid_data->iterator_idle_id = 0;
+    gtk_widget_set_sensitive(grid_data->cancel_button, FALSE);
+    if (status == ITERATOR_FOUND) {
+        history->newest = (history->newest + 1) % SOLUTION_HISTORY_SIZE;
+        memcpy(history->placements[history->newest], placement, it->n);
+        history->numbers[history->newest] = it->solutions;
+        if (history->count < SOLUTION_HISTORY_SIZE) history->count++;
+        history->back = 0;
+        grid_data->solution_count = it->solutions;
+        show_history_entry(grid_data);
     } else {
-        gtk_widget_set_name(cell, "queen-cell");
+        char progress_text[100];
+        snprintf(progress_text, sizeof(progress_text), "Toutes les solutions ont été parcourues (%lld)", it->solutions);
+        gtk_label_set_text(GTK_LABEL(grid_data->progress_label), progress_text);
     }
+    update_counter_labels(grid_data);
+    return G_SOURCE_REMOVE;
+}
 
-    return G_SOURCE_CONTINUE;
+static void request_next_solution(GridData *grid_data) {
+    if (grid_data->iterator_idle_id > 0) return;
+    gtk_widget_set_sensitive(grid_data->cancel_button, TRUE);
+    grid_data->iterator_idle_id = g_idle_add(pull_next_solution, grid_data);
+}
+
+/* On-demand mode: nothing is solved up front; each "next" pulls one more solution
+ * from the iterator and the history ring serves "previous". */
+static void start_lazy_browsing(GridData *grid_data) {
+    solution_iterator_init(&grid_data->iterator, grid_data->current_size);
+    grid_data->history.newest = SOLUTION_HISTORY_SIZE - 1;
+    grid_data->history.count = 0;
+    grid_data->history.back = 0;
+    gtk_label_set_text(GTK_LABEL(grid_data->progress_label), "");
+    request_next_solution(grid_data);
 }
 
-static gboolean update_ui_after_solve(gpointer data) {
+static void cancel_solve(GtkWidget *widget, gpointer data) {
     GridData *grid_data = (GridData *)data;
+    if (grid_data->iterator_idle_id > 0) {
+        stop_iterator(grid_data);
+        gtk_label_set_text(GTK_LABEL(grid_data->progress_label), "Recherche annulée");
+        gtk_widget_set_sensitive(grid_data->cancel_button, FALSE);
+        return;
+    }
+    if (!solver_busy(grid_data)) return;
 
+    if (grid_data->solve_job) atomic_store(&grid_data->solve_job->cancel, true);
+    if (grid_data->jump_job) atomic_store(&grid_data->jump_job->cancel, true);
+    gtk_widget_set_sensitive(grid_data->cancel_button, FALSE);
+}
+
+/* Ends the search trace and clears its queens and tint from the board. */
+static void stop_animation(GridData *grid_data) {
+    if (!grid_data->animation_running) return;
     grid_data->animation_running = FALSE;
     if (grid_data->animation_timer_id > 0) {
         g_source_remove(grid_data->animation_timer_id);
         grid_data->animation_timer_id = 0;
     }
 
-    char operation_text[50];
-    snprintf(operation_text, sizeof(operation_text), "Operations: %d", grid_data->operation_count);
-    gtk_label_set_text(GTK_LABEL(grid_data->operation_label), operation_text);
+    BoardView *view = &grid_data->board;
+    view->heat = NULL;
+    for (int col = 0; col < view->n; col++) view->rows[col] = -1;
+    board_view_invalidate(view);
+}
 
-    char solution_count_text[50];
-    snprintf(solution_count_text, sizeof(solution_count_text), "Solutions: %d", grid_data->solution_count);
-    gtk_label_set_text(GTK_LABEL(grid_data->solution_count_label), solution_count_text);
+/* Hands the arena back to the store if it is still showing this run, or adopts it as
+ * the arena when the store has not allocated a new one; otherwise it goes with the job. */
+static gboolean finish_cache_save(gpointer data) {
+    SolverJob *job = data;
+    CacheSave *save = job->data;
+    SolutionStore *store = &save->grid_data->solutions;
+    if (!store->data) {
+        if (store->mapped == save->data) store->mapped = NULL;
+        store->data = save->data;
+        store->capacity = save->capacity;
+        save->data = NULL;
+    }
+    solver_job_release(job);
+    return G_SOURCE_REMOVE;
+}
+
+static void run_cache_save(SolverJob *job) {
+    solution_cache_save(job->data);
+    solver_job_retain(job);
+    g_idle_add(finish_cache_save, job);
+}
 
-    if (grid_data->solution_count > 0) {
+static void free_cache_save(void *data) {
+    CacheSave *save = data;
+    free(save->data);
+    free(save);
+}
+
+/* Writes a finished run to the cache on the solver service. Until the job is done the
+ * store reads the placements through its mapped pointer, so nothing appends to the
+ * arena being written. Runs whose store hit its size limit are not cached. */
+static void start_cache_save(GridData *grid_data, long long solutions, long long operations) {
+    SolutionStore *store = &grid_data->solutions;
+    if (!method_is_cacheable(grid_data->current_method, grid_data->current_size) || store->truncated || store->mapped) {
+        return;
+    }
+
+    CacheSave *save = calloc(1, sizeof(CacheSave));
+    save->grid_data = grid_data;
+    save->n = grid_data->current_size;
+    save->method = grid_data->current_method;
+    save->flags = grid_data->symmetry_reduced ? SOLUTION_CACHE_SYMMETRY_REDUCED : 0;
+    save->solutions = solutions;
+    save->operations = operations;
+    save->data = store->data;
+    save->capacity = store->capacity;
+    save->count = store->count;
+    save->stride = store->stride;
+
+    store->mapped = store->data;
+    store->data = NULL;
+    store->capacity = 0;
+
+    SolverJob *job = solver_job_new(SOLVER_LANE_BACKGROUND, run_cache_save, save, free_cache_save);
+    solver_service_submit(job);
+    solver_job_release(job); /* nobody waits for a save */
+}
+
+/* Runs every UI frame while a solve is in flight: moves published batches into the
+ * store, refreshes the counters and shows the first solution once the board is free. */
+static gboolean drain_solution_queue(gpointer data) {
+    GridData *grid_data = (GridData *)data;
+    SolverJob *job = grid_data->solve_job;
+    if (!job) {
+        stop_animation(grid_data);
+        grid_data->drain_timer_id = 0;
+        return G_SOURCE_REMOVE;
+    }
+
+    SolveRequest *request = job->data;
+    bool had_solutions = grid_data->solutions.count > 0;
+    bool finished = false;
+    bool cancelled = false;
+    double progress = -1.0;
+    long long solutions = 0;
+    long long operations = 0;
+
+    SolutionBatch *batch;
+    while ((batch = solution_queue_pop(&request->queue)) != NULL) {
+        for (int i = 0; i < batch->count; i++) {
+            solution_store_append(&grid_data->solutions, batch->placements + (size_t)i * grid_data->solutions.stride);
+        }
+        grid_data->solution_count = batch->solution_count;
+        grid_data->operation_count = batch->operation_count;
+        grid_data->stats = batch->stats;
+        solutions = batch->solution_count;
+        operations = batch->operation_count;
+        progress = batch->progress;
+        finished = batch->finished;
+        cancelled = batch->cancelled;
+        solution_batch_free(batch);
+    }
+
+    update_counter_labels(grid_data);
+    update_progress_label(grid_data, progress, finished, cancelled);
+
+    /* The trace holds the board until the search ends or the user browses the
+     * solutions found so far; then the first solution is shown. */
+    bool tracing = grid_data->animation_running;
+    if (tracing && finished) stop_animation(grid_data);
+
+    if (grid_data->solutions.count > 0 && (tracing ? finished : !had_solutions)) {
         grid_data->current_solution_index = 0;
+        grid_data->current_symmetry = 0;
         update_grid_display(grid_data);
     }
 
-    gtk_widget_set_sensitive(grid_data->generate_button, TRUE);
+    if (!finished) return G_SOURCE_CONTINUE;
 
-    grid_data->thread_running = FALSE;
+    if (!cancelled) start_cache_save(grid_data, solutions, operations);
+
+    if (!grid_data->jump_job) gtk_widget_set_sensitive(grid_data->cancel_button, FALSE);
+
+    solver_job_release(job);
+    grid_data->solve_job = NULL;
+    grid_data->drain_timer_id = 0;
     return G_SOURCE_REMOVE;
 }
 
-static void* solver_thread_func(void *arg) {
-    ThreadData *thread_data = (ThreadData *)arg;
-    GridData *grid_data = thread_data->grid_data;
-    int size = thread_data->size;
-    int method = thread_data->method;
+/* Serves a repeat request from the solution cache: the store borrows the mapped
+ * placements directly, so nothing is copied or re-solved. */
+static void show_cached_solutions(GridData *grid_data, const SolutionCacheHeader *header) {
+    grid_data->solutions.mapped = (const unsigned char *)(header + 1);
+    grid_data->solutions.count = header->stored_count;
+    grid_data->solution_count = (long long)header->solution_count;
+    grid_data->operation_count = (long long)header->operation_count;
+    grid_data->current_solution_index = 0;
+    if (grid_data->solutions.count > 0) update_grid_display(grid_data);
+    update_counter_labels(grid_data);
+
+    char progress_text[100];
+    snprintf(progress_text, sizeof(progress_text), "Chargé depuis le cache en %.2f ms",
+             (g_get_monotonic_time() - grid_data->solve_start_us) / 1e3);
+    gtk_label_set_text(GTK_LABEL(grid_data->progress_label), progress_text);
+}
 
-    int **board = malloc(size * sizeof(int *));
-    for (int i = 0; i < size; i++) {
-        board[i] = calloc(size, sizeof(int));
+/* Shows the answer to the newest completion request; answers to requests that were
+ * superseded while they ran are dropped. */
+static gboolean finish_completion(gpointer data) {
+    SolverJob *job = data;
+    CompletionData *completion = job->data;
+    GridData *grid_data = completion->grid_data;
+    if (job != grid_data->completion_job || !grid_data->editing) {
+        solver_job_release(job);
+        return G_SOURCE_REMOVE;
+    }
+    grid_data->completion_job = NULL;
+    solver_job_release(job);
+
+    BoardView *view = &grid_data->board;
+    cairo_t *cr = board_view_begin(view);
+    for (int col = 0; col < view->n; col++) {
+        int row = completion->found ? completion->placement[col] : completion->constraints.pinned[col];
+        board_view_move_queen(view, cr, col, row);
     }
+    board_view_end(view, cr);
 
-    switch (method) {
-        case 0:
-            if (solve_n_queens_intuitive(board, 0, size, &grid_data->operation_count)) {
-                grid_data->solution_count = 1;
-                for (int i = 0; i < size; i++) {
-                    for (int j = 0; j < size; j++) {
-                        grid_data->solutions[0][i * size + j] = board[i][j];
-                    }
-                }
-            }
-            break;
-        case 1:
-            solve_n_queens_arborescent(board, 0, size, &grid_data->operation_count, grid_data->solutions, &grid_data->solution_count);
-            break;
-        case 2:
-            generate_all_configurations(board, 0, size, &grid_data->operation_count, grid_data->solutions, &grid_data->solution_count);
-            break;
+    grid_data->solution_count = completion->found ? 1 : 0;
+    grid_data->operation_count = completion->nodes;
+    update_counter_labels(grid_data);
+
+    char progress_text[100];
+    if (completion->found) {
+        snprintf(progress_text, sizeof(progress_text), "Complétion trouvée en %.2f ms", completion->elapsed_ns / 1e6);
+    } else {
+        snprintf(progress_text, sizeof(progress_text), "Aucune complétion avec ces contraintes (%.2f ms)",
+                 completion->elapsed_ns / 1e6);
     }
+    gtk_label_set_text(GTK_LABEL(grid_data->progress_label), progress_text);
+    solver_job_release(job);
+    return G_SOURCE_REMOVE;
+}
+
+static void run_completion_job(SolverJob *job) {
+    CompletionData *completion = job->data;
+    CountState state = {0, &job->cancel, false, NULL};
+    uint64_t start = monotonic_ns();
+    completion->found = complete_board(&completion->constraints, completion->placement, &state);
+    completion->elapsed_ns = monotonic_ns() - start;
+    completion->nodes = state.operations;
+    solver_job_retain(job);
+    g_idle_add(finish_completion, job);
+}
+
+/* Solves the current constraints on the solver service; the request still in flight
+ * (if any) is superseded, so only the newest set of constraints gets an answer. */
+static void start_completion(GridData *grid_data) {
+    if (grid_data->completion_job) solver_job_abandon(grid_data->completion_job);
 
-    for (int i = 0; i < size; i++) {
-        free(board[i]);
+    CompletionData *completion = calloc(1, sizeof(CompletionData));
+    completion->grid_data = grid_data;
+    completion->constraints = grid_data->constraints;
+    grid_data->completion_job = solver_job_new(SOLVER_LANE_COMPLETION, run_completion_job, completion, free);
+    solver_service_submit(grid_data->completion_job);
+}
+
+/* In edit mode a click cycles the square: free -> pinned queen -> blocked -> free.
+ * Pinning replaces any other queen pinned in the same column. */
+static void board_clicked(GtkGestureClick *gesture, int n_press, double x, double y, gpointer data) {
+    GridData *grid_data = (GridData *)data;
+    int col, row;
+    if (!grid_data->editing || !board_view_cell_at(&grid_data->board, x, y, &col, &row)) return;
+
+    BoardConstraints *constraints = &grid_data->constraints;
+    uint32_t bit = 1u << row;
+    if (constraints->pinned[col] == row) {
+        constraints->pinned[col] = -1;
+        constraints->blocked[col] |= bit;
+    } else if (constraints->blocked[col] & bit) {
+        constraints->blocked[col] &= ~bit;
+    } else {
+        constraints->pinned[col] = row;
     }
-    free(board);
+    board_view_invalidate(&grid_data->board);
+    start_completion(grid_data);
+}
 
-    g_idle_add((GSourceFunc)update_ui_after_solve, grid_data);
-    
-    free(thread_data);
-    return NULL;
+static void begin_editing(GridData *grid_data) {
+    int size = gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(grid_data->size_spin));
+    if (size > BITBOARD_MAX_SIZE) {
+        gtk_label_set_text(GTK_LABEL(grid_data->progress_label), "Mode édition limité aux grilles jusqu'à 32");
+        gtk_check_button_set_active(GTK_CHECK_BUTTON(grid_data->edit_check), FALSE);
+        return;
+    }
+
+    stop_iterator(grid_data);
+    solution_store_reset(&grid_data->solutions, size);
+    grid_data->current_size = size;
+    grid_data->lazy_browsing = false;
+    grid_data->indexed_browsing = false;
+    grid_data->symmetry_reduced = false;
+    memset(&grid_data->stats, 0, sizeof(grid_data->stats));
+    board_constraints_reset(&grid_data->constraints, size);
+    grid_data->editing = true;
+
+    board_view_reset(&grid_data->board, size);
+    grid_data->board.constraints = &grid_data->constraints;
+    start_completion(grid_data);
+}
+
+/* Edit mode takes over the board until it is switched off or a solve is started. */
+static void toggle_editing(GtkCheckButton *check, gpointer data) {
+    GridData *grid_data = (GridData *)data;
+    bool active = gtk_check_button_get_active(check);
+    if (active == grid_data->editing) return;
+
+    if (active) {
+        if (solver_busy(grid_data)) {
+            gtk_label_set_text(GTK_LABEL(grid_data->progress_label), "Une recherche est déjà en cours");
+            gtk_check_button_set_active(check, FALSE);
+            return;
+        }
+        begin_editing(grid_data);
+        return;
+    }
+
+    grid_data->editing = false;
+    if (grid_data->completion_job) solver_job_abandon(grid_data->completion_job);
+    grid_data->completion_job = NULL;
+    grid_data->board.constraints = NULL;
+    board_view_invalidate(&grid_data->board);
+}
+
+static void size_changed(GtkSpinButton *spin, gpointer data) {
+    GridData *grid_data = (GridData *)data;
+    if (grid_data->editing) begin_editing(grid_data);
+}
+
+static void run_solve_job(SolverJob *job) {
+    SolveRequest *request = job->data;
+    SolverOutput out;
+    solver_output_init(&out, &request->queue, request->size);
+    out.snapshot = &request->snapshot;
+    out.cancel = &job->cancel;
+    out.detached = &job->detached;
+    run_solver(request->method, request->size, &out);
+    solver_output_finish(&out);
+}
+
+/* Batches left in an abandoned request's queue go with it. */
+static void free_solve_request(void *data) {
+    SolveRequest *request = data;
+    SolutionBatch *batch;
+    while ((batch = solution_queue_pop(&request->queue)) != NULL) solution_batch_free(batch);
+    free(request);
+}
+
+static void start_solve(GridData *grid_data) {
+    grid_data->animation_running = TRUE;
+    grid_data->animation_timer_id = g_timeout_add(UI_FRAME_INTERVAL_MS, search_trace_animation, grid_data);
+
+    gtk_widget_set_sensitive(grid_data->cancel_button, TRUE);
+    gtk_label_set_text(GTK_LABEL(grid_data->progress_label), "Progression: 0.0 %");
+    grid_data->solve_start_us = g_get_monotonic_time();
+
+    SolveRequest *request = calloc(1, sizeof(SolveRequest));
+    request->size = grid_data->current_size;
+    request->method = grid_data->current_method;
+    atomic_init(&request->queue.head, 0);
+    atomic_init(&request->queue.tail, 0);
+    search_snapshot_init(&request->snapshot);
+    grid_data->solve_job = solver_job_new(SOLVER_LANE_SOLVE, run_solve_job, request, free_solve_request);
+    solver_service_submit(grid_data->solve_job);
+
+    if (grid_data->drain_timer_id == 0) {
+        grid_data->drain_timer_id = g_timeout_add(UI_FRAME_INTERVAL_MS, drain_solution_queue, grid_data);
+    }
+}
+
+/* Serves the file mapped by the newest load, or solves when there is none; loads
+ * superseded by a new request are dropped and their mapping unmapped with them. */
+static gboolean finish_cache_load(gpointer data) {
+    SolverJob *job = data;
+    CacheLoad *load = job->data;
+    GridData *grid_data = load->grid_data;
+    if (job != grid_data->cache_job) {
+        solver_job_release(job);
+        return G_SOURCE_REMOVE;
+    }
+    grid_data->cache_job = NULL;
+    solver_job_release(job);
+
+    if (load->mapping) {
+        show_cached_solutions(grid_data, solution_cache_install(load->n, load->method, load->mapping, load->size));
+        load->mapping = NULL;
+    } else {
+        start_solve(grid_data);
+    }
+    solver_job_release(job);
+    return G_SOURCE_REMOVE;
+}
+
+static void run_cache_load(SolverJob *job) {
+    CacheLoad *load = job->data;
+    if (!atomic_load(&job->cancel)) load->mapping = solution_cache_map(load->n, load->method, &load->size);
+    solver_job_retain(job);
+    g_idle_add(finish_cache_load, job);
+}
+
+static void free_cache_load(void *data) {
+    CacheLoad *load = data;
+    if (load->mapping) solution_cache_unmap(load->mapping, load->size);
+    free(load);
+}
+
+/* A run mapped earlier is served straight from the table; a file seen for the first
+ * time is mapped and checksummed on the solver service before it is trusted. */
+static void load_or_solve(GridData *grid_data) {
+    int n = grid_data->current_size;
+    SolverMethod method = grid_data->current_method;
+    if (!method_is_cacheable(method, n)) {
+        start_solve(grid_data);
+        return;
+    }
+
+    grid_data->solve_start_us = g_get_monotonic_time();
+    const SolutionCacheHeader *header = solution_cache_find(n, method);
+    if (header) {
+        show_cached_solutions(grid_data, header);
+        return;
+    }
+
+    gtk_label_set_text(GTK_LABEL(grid_data->progress_label), "Lecture du cache...");
+    CacheLoad *load = calloc(1, sizeof(CacheLoad));
+    load->grid_data = grid_data;
+    load->n = n;
+    load->method = method;
+    grid_data->cache_job = solver_job_new(SOLVER_LANE_CACHE_LOAD, run_cache_load, load, free_cache_load);
+    solver_service_submit(grid_data->cache_job);
 }
 
 static void generate_grid(GtkWidget *widget, gpointer data) {
     GridData *grid_data = (GridData *)data;
     
-    if (grid_data->thread_running) return;
+    if (grid_data->editing) gtk_check_button_set_active(GTK_CHECK_BUTTON(grid_data->edit_check), FALSE);
     
-    int size = gtk_drop_down_get_selected(GTK_DROP_DOWN(grid_data->size_dropdown)) + 3;
+    int size = gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(grid_data->size_spin));
     int method = gtk_drop_down_get_selected(GTK_DROP_DOWN(grid_data->method_dropdown));
 
-    if (grid_data->grid) {
-        gtk_widget_unparent(grid_data->grid);
+    if (size > method_max_size(method)) {
+        char limit_text[100];
+        snprintf(limit_text, sizeof(limit_text), "Taille maximale pour cette méthode: %d", method_max_size(method));
+        gtk_label_set_text(GTK_LABEL(grid_data->progress_label), limit_text);
+        return;
     }
 
-    grid_data->grid = gtk_grid_new();
-    gtk_widget_set_name(grid_data->grid, "chess-grid");
-    gtk_grid_set_row_homogeneous(GTK_GRID(grid_data->grid), TRUE);
-    gtk_grid_set_column_homogeneous(GTK_GRID(grid_data->grid), TRUE);
+    /* A new request replaces whatever is still running: the old solve or cache load is
+     * dropped and a pending jump is told its answer is no longer wanted. */
+    if (grid_data->solve_job) {
+        solver_job_abandon(grid_data->solve_job);
+        grid_data->solve_job = NULL;
+    }
+    if (grid_data->cache_job) {
+        solver_job_abandon(grid_data->cache_job);
+        grid_data->cache_job = NULL;
+    }
+    stop_animation(grid_data);
+    if (grid_data->jump_job) {
+        atomic_store(&grid_data->jump_job->detached, true);
+        atomic_store(&grid_data->jump_job->cancel, true);
+    }
 
-    for (int i = 0; i < size; i++) {
-        for (int j = 0; j < size; j++) {
-            GtkWidget *cell = gtk_button_new();
-            gtk_widget_set_name(cell, "grid-cell");
-            gtk_widget_set_size_request(cell, 50, 50);
-            gtk_grid_attach(GTK_GRID(grid_data->grid), cell, j, i, 1, 1);
-        }
+    board_view_reset(&grid_data->board, size);
+
+    solution_store_reset(&grid_data->solutions, size);
+    grid_data->solution_count = 0;
+    grid_data->operation_count = 0;
+    memset(&grid_data->stats, 0, sizeof(grid_data->stats));
+    grid_data->current_size = size;
+    grid_data->current_method = method;
+    grid_data->current_symmetry = 0;
+    grid_data->indexed_browsing = false;
+    grid_data->symmetry_reduced = (method == METHOD_SYMMETRIC);
+
+    stop_iterator(grid_data);
+    grid_data->lazy_browsing = gtk_check_button_get_active(GTK_CHECK_BUTTON(grid_data->lazy_check))
+                               && size <= BITBOARD_MAX_SIZE;
+    if (grid_data->lazy_browsing) {
+        start_lazy_browsing(grid_data);
+        return;
     }
 
-    gtk_box_append(GTK_BOX(grid_data->grid_container), grid_data->grid);
-    gtk_widget_set_visible(grid_data->grid, TRUE);
+    load_or_solve(grid_data);
+}
 
-    if (grid_data->solutions) {
-        for (int i = 0; i < grid_data->solution_count; i++) {
-            free(grid_data->solutions[i]);
+static gboolean finish_jump(gpointer data) {
+    SolverJob *job = data;
+    JumpData *jump = job->data;
+    GridData *grid_data = jump->grid_data;
+    grid_data->jump_job = NULL;
+
+    /* A jump superseded by a new solve has nothing left to show. */
+    if (!atomic_load(&job->detached)) {
+        char progress_text[100];
+        if (jump->found) {
+            BoardView *view = &grid_data->board;
+            cairo_t *cr = board_view_begin(view);
+            for (int col = 0; col < view->n; col++) board_view_move_queen(view, cr, col, jump->placement[col]);
+            board_view_end(view, cr);
+
+            grid_data->indexed_browsing = true;
+            grid_data->current_rank = jump->rank;
+            gtk_spin_button_set_value(GTK_SPIN_BUTTON(grid_data->jump_spin), (double)(jump->rank + 1));
+            if (jump->total >= 0) {
+                snprintf(progress_text, sizeof(progress_text), "Solution n°%lld sur %lld", jump->rank + 1, jump->total);
+            } else {
+                snprintf(progress_text, sizeof(progress_text), "Solution n°%lld", jump->rank + 1);
+            }
+        } else if (atomic_load(&job->cancel)) {
+            snprintf(progress_text, sizeof(progress_text), "Recherche annulée");
+        } else {
+            snprintf(progress_text, sizeof(progress_text), "Il n'y a que %lld solutions", jump->total);
         }
-        free(grid_data->solutions);
+        gtk_label_set_text(GTK_LABEL(grid_data->progress_label), progress_text);
     }
 
-    grid_data->solutions = malloc(1000 * sizeof(int *));
-    for (int i = 0; i < 1000; i++) {
-        grid_data->solutions[i] = malloc(size * size * sizeof(int));
+    if (!grid_data->solve_job) gtk_widget_set_sensitive(grid_data->cancel_button, FALSE);
+    /* the UI's reference, then the one taken for this callback */
+    solver_job_release(job);
+    solver_job_release(job);
+    return G_SOURCE_REMOVE;
+}
+
+/* The index belongs to the grid but is only touched by the jump job while
+ * grid_data->jump_job is set, and start_jump waits for that to clear. */
+static void run_jump_job(SolverJob *job) {
+    JumpData *jump = job->data;
+    CountState state = {0, &job->cancel, false, NULL};
+
+    jump->found = solution_index_unrank(jump->index, jump->rank, jump->placement, &state);
+    jump->total = solution_index_known_total(jump->index);
+    solver_job_retain(job);
+    g_idle_add(finish_jump, job);
+}
+
+/* Shows the rank-th solution of the current board size without enumerating up to it.
+ * Subtree counts found on the way are kept in the index for the following jumps. */
+static void start_jump(GridData *grid_data, long long rank) {
+    int n = grid_data->current_size;
+    if (grid_data->jump_job) return;
+    if (n < 1 || n > BITBOARD_MAX_SIZE) {
+        gtk_label_set_text(GTK_LABEL(grid_data->progress_label), "Accès direct limité aux grilles jusqu'à 32");
+        return;
     }
 
-    grid_data->solution_count = 0;
-    grid_data->operation_count = 0;
-    grid_data->current_size = size;
+    if (grid_data->index.n != n) solution_index_reset(&grid_data->index, n);
+    gtk_label_set_text(GTK_LABEL(grid_data->progress_label), "Recherche de la solution...");
 
-    grid_data->animation_running = TRUE;
-    grid_data->animation_timer_id = g_timeout_add(100, random_grid_animation, grid_data);
+    JumpData *jump = calloc(1, sizeof(JumpData));
+    jump->grid_data = grid_data;
+    jump->index = &grid_data->index;
+    jump->rank = rank;
 
-    gtk_widget_set_sensitive(grid_data->generate_button, FALSE);
+    gtk_widget_set_sensitive(grid_data->cancel_button, TRUE);
+    grid_data->jump_job = solver_job_new(SOLVER_LANE_JUMP, run_jump_job, jump, free);
+    solver_service_submit(grid_data->jump_job);
+}
 
-    ThreadData *thread_data = malloc(sizeof(ThreadData));
-    thread_data->grid_data = grid_data;
-    thread_data->size = size;
-    thread_data->method = method;
-    
-    grid_data->thread_running = TRUE;
-    pthread_create(&grid_data->solver_thread, NULL, solver_thread_func, thread_data);
-    pthread_detach(grid_data->solver_thread);
+static void jump_to_solution(GtkWidget *widget, gpointer data) {
+    GridData *grid_data = (GridData *)data;
+    if (grid_data->editing) return;
+    start_jump(grid_data, (long long)gtk_spin_button_get_value(GTK_SPIN_BUTTON(grid_data->jump_spin)) - 1);
 }
 
 static void show_next_solution(GtkWidget *widget, gpointer data) {
     GridData *grid_data = (GridData *)data;
-    if (grid_data->solution_count == 0) return;
+    if (grid_data->editing) return;
+    if (grid_data->indexed_browsing) {
+        start_jump(grid_data, grid_data->current_rank + 1);
+        return;
+    }
+    if (grid_data->lazy_browsing) {
+        if (grid_data->history.back > 0) {
+            grid_data->history.back--;
+            show_history_entry(grid_data);
+        } else {
+            request_next_solution(grid_data);
+        }
+        return;
+    }
+
+    int count = (int)grid_data->solutions.count;
+    if (count == 0) return;
+    stop_animation(grid_data);
+
+    if (grid_data->symmetry_reduced) {
+        step_symmetric_solution(grid_data, 1);
+        update_grid_display(grid_data);
+        return;
+    }
 
-    grid_data->current_solution_index = (grid_data->current_solution_index + 1) % grid_data->solution_count;
+    grid_data->current_solution_index = (grid_data->current_solution_index + 1) % count;
     update_grid_display(grid_data);
 }
 
 static void show_previous_solution(GtkWidget *widget, gpointer data) {
     GridData *grid_data = (GridData *)data;
-    if (grid_data->solution_count == 0) return;
+    if (grid_data->editing) return;
+    if (grid_data->indexed_browsing) {
+        if (grid_data->current_rank > 0) start_jump(grid_data, grid_data->current_rank - 1);
+        return;
+    }
+    if (grid_data->lazy_browsing) {
+        if (grid_data->history.back + 1 < grid_data->history.count) {
+            grid_data->history.back++;
+            show_history_entry(grid_data);
+        }
+        return;
+    }
+
+    int count = (int)grid_data->solutions.count;
+    if (count == 0) return;
+    stop_animation(grid_data);
 
-    grid_data->current_solution_index = (grid_data->current_solution_index - 1 + grid_data->solution_count) % grid_data->solution_count;
+    if (grid_data->symmetry_reduced) {
+        step_symmetric_solution(grid_data, -1);
+        update_grid_display(grid_data);
+        return;
+    }
+
+    grid_data->current_solution_index = (grid_data->current_solution_index - 1 + count) % count;
     update_grid_display(grid_data);
 }
 
@@ -321,19 +1577,104 @@ static void switch_to_main_menu(GtkWidget *widget, gpointer data) {
     gtk_stack_set_visible_child_name(stack, "main");
 }
 
-static void switch_to_about(GtkWidget *widget, gpointer data) {
-    GtkStack *stack = GTK_STACK(data);
-    gtk_stack_set_visible_child_name(stack, "about");
+/* Images are decoded on short-lived worker threads, already scaled to the size they are
+ * shown at, and handed to the widget as a GdkTexture so GTK uploads them to the GPU
+ * once. Decoded variants are cached per (path, size) on the main thread. */
+#define ASSET_CACHE_SIZE 16
+
+typedef void (*AssetReadyFunc)(gpointer target, GdkTexture *texture);
+
+typedef struct {
+    char *path;
+    int size;
+    GdkTexture *texture;
+} AssetEntry;
+
+typedef struct {
+    char *path;
+    int size;
+    AssetReadyFunc ready;
+    gpointer target;
+    GdkTexture *texture;
+} AssetLoad;
+
+static AssetEntry asset_cache[ASSET_CACHE_SIZE];
+static int asset_cache_count = 0;
+
+static GdkTexture *asset_cache_lookup(const char *path, int size) {
+    for (int i = 0; i < asset_cache_count; i++) {
+        if (asset_cache[i].size == size && strcmp(asset_cache[i].path, path) == 0) return asset_cache[i].texture;
+    }
+    return NULL;
+}
+
+static void asset_cache_insert(const char *path, int size, GdkTexture *texture) {
+    if (asset_cache_count == ASSET_CACHE_SIZE || asset_cache_lookup(path, size)) return;
+    asset_cache[asset_cache_count++] = (AssetEntry){g_strdup(path), size, g_object_ref(texture)};
+}
+
+static gboolean finish_asset_load(gpointer data) {
+    AssetLoad *load = data;
+    if (load->texture) {
+        asset_cache_insert(load->path, load->size, load->texture);
+        load->ready(load->target, load->texture);
+        g_object_unref(load->texture);
+    }
+    g_object_unref(load->target);
+    g_free(load->path);
+    g_free(load);
+    return G_SOURCE_REMOVE;
+}
+
+/* A size of 0 keeps the image at its native resolution; otherwise it is decoded to fit
+ * a size x size box, which for the avatars skips carrying 1080px images around. */
+static void *run_asset_load(void *arg) {
+    AssetLoad *load = arg;
+    GError *error = NULL;
+    GdkPixbuf *pixbuf = load->size > 0
+        ? gdk_pixbuf_new_from_file_at_scale(load->path, load->size, load->size, TRUE, &error)
+        : gdk_pixbuf_new_from_file(load->path, &error);
+    if (pixbuf) {
+        load->texture = gdk_texture_new_for_pixbuf(pixbuf);
+        g_object_unref(pixbuf);
+    } else {
+        g_warning("Failed to load %s: %s", load->path, error->message);
+        g_error_free(error);
+    }
+    g_idle_add(finish_asset_load, load);
+    return NULL;
 }
 
-static void draw_background(GtkDrawingArea *area, cairo_t *cr, int width, int height, gpointer data) {
-    GdkPixbuf *original_pixbuf = data;
-    if (original_pixbuf) {
-        GdkPixbuf *scaled_pixbuf = gdk_pixbuf_scale_simple(original_pixbuf, width, height, GDK_INTERP_BILINEAR);
-        gdk_cairo_set_source_pixbuf(cr, scaled_pixbuf, 0, 0);
-        cairo_paint(cr);
-        g_object_unref(scaled_pixbuf);
+/* Calls ready(target, texture) on the main thread once the image is available: right
+ * away on a cache hit, otherwise after a background decode. target is kept alive until
+ * then. Nothing is called if the file cannot be decoded. */
+static void asset_load(const char *path, int size, AssetReadyFunc ready, gpointer target) {
+    GdkTexture *cached = asset_cache_lookup(path, size);
+    if (cached) {
+        ready(target, cached);
+        return;
+    }
+
+    AssetLoad *load = g_new0(AssetLoad, 1);
+    load->path = g_strdup(path);
+    load->size = size;
+    load->ready = ready;
+    load->target = g_object_ref(target);
+
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, run_asset_load, load) != 0) {
+        run_asset_load(load);
+        return;
     }
+    pthread_detach(thread);
+}
+
+static void set_image_texture(gpointer target, GdkTexture *texture) {
+    gtk_image_set_from_paintable(GTK_IMAGE(target), GDK_PAINTABLE(texture));
+}
+
+static void set_picture_texture(gpointer target, GdkTexture *texture) {
+    gtk_picture_set_paintable(GTK_PICTURE(target), GDK_PAINTABLE(texture));
 }
 
 static GtkWidget *create_developer_card(const char *name, const char *role, const char *image_path) {
@@ -342,9 +1683,10 @@ static GtkWidget *create_developer_card(const char *name, const char *role, cons
     gtk_widget_add_css_class(card, "developer-card");
     gtk_widget_set_halign(card, GTK_ALIGN_CENTER);
     
-    GtkWidget *avatar = gtk_image_new_from_file(image_path);
+    GtkWidget *avatar = gtk_image_new();
     gtk_image_set_pixel_size(GTK_IMAGE(avatar), 200);
     gtk_widget_set_margin_top(avatar, 20);
+    asset_load(image_path, 200, set_image_texture, avatar);
     
     GtkWidget *name_label = gtk_label_new(NULL);
     gtk_label_set_markup(GTK_LABEL(name_label), 
@@ -362,6 +1704,60 @@ static GtkWidget *create_developer_card(const char *name, const char *role, cons
     return card;
 }
 
+/* The About page is only built the first time it is opened, so its avatars are not
+ * decoded at startup. */
+static void build_about_page(GtkStack *stack) {
+    GtkWidget *about_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 30);
+    gtk_widget_set_margin_start(about_box, 40);
+    gtk_widget_set_margin_end(about_box, 40);
+    gtk_widget_set_margin_top(about_box, 40);
+    gtk_widget_set_margin_bottom(about_box, 40);
+
+    GtkWidget *about_title = gtk_label_new(NULL);
+    gtk_label_set_markup(GTK_LABEL(about_title), "<span font='48' weight='bold' foreground='#fde68a'>Developers</span>");
+    gtk_widget_set_margin_bottom(about_title, 40);
+    gtk_box_append(GTK_BOX(about_box), about_title);
+
+    GtkWidget *cards_box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 20);
+    gtk_widget_set_halign(cards_box, GTK_ALIGN_CENTER);
+    gtk_widget_set_margin_top(cards_box, 40);
+
+    const char *developers[][3] = {
+        {"HASSOUNE ZAKARIA", "TESTER DEVELOPERS", "avatar1.png"},
+        {"AZOUGEN ZINEB", "TESTER DEVELOPERS", "avatar2.png"},
+        {"OUKHRID MOHAMED AMINE", "DESIGNER DEVELOPERS", "avatar3.png"},
+        {"ABOUHAFSS OUSSAMA", "SCRUM MA DEVELOPERS", "avatar4.png"},
+        {"AZEMRAY OUALID", "TESTER DEVELOPERS", "avatar5.png"}
+    };
+
+    for (int i = 0; i < 5; i++) {
+        GtkWidget *card = create_developer_card(
+            developers[i][0], 
+            developers[i][1],
+            developers[i][2]
+        );
+        gtk_box_append(GTK_BOX(cards_box), card);
+    }
+    gtk_box_append(GTK_BOX(about_box), cards_box);
+
+    GtkWidget *back_button_about = gtk_button_new_with_label("BACK");
+    gtk_widget_set_name(back_button_about, "back-button");
+    gtk_widget_set_halign(back_button_about, GTK_ALIGN_START);
+    gtk_widget_set_valign(back_button_about, GTK_ALIGN_END);
+    gtk_widget_set_margin_start(back_button_about, 20);
+    gtk_widget_set_margin_bottom(back_button_about, 20);
+    gtk_box_append(GTK_BOX(about_box), back_button_about);
+    g_signal_connect(back_button_about, "clicked", G_CALLBACK(switch_to_main_menu), stack);
+
+    gtk_stack_add_named(stack, about_box, "about");
+}
+
+static void switch_to_about(GtkWidget *widget, gpointer data) {
+    GtkStack *stack = GTK_STACK(data);
+    if (!gtk_stack_get_child_by_name(stack, "about")) build_about_page(stack);
+    gtk_stack_set_visible_child_name(stack, "about");
+}
+
 static void activate(GtkApplication *app, gpointer user_data) {
     GtkWidget *window = gtk_application_window_new(app);
     gtk_window_set_title(GTK_WINDOW(window), "8 Reines Solver");
@@ -376,15 +1772,12 @@ static void activate(GtkApplication *app, gpointer user_data) {
     "#solve-button { background: transparent; color: #D4AF37; border: 2px solid #D4AF37; border-radius: 25px; padding: 15px 30px; font-size: 20px; font-weight: bold; min-width: 150px; max-width: 150px; transition: transform 0.3s, background-color 0.3s; }"
     "#solve-button:hover { background-color: rgba(212, 175, 55, 0.1); transform: scale(1.1); }"
     "#input-label { color: #D4AF37; font-size: 18px; font-weight: bold; }"
-    "#size-dropdown { background: rgba(255, 255, 255, 0.1); color: white; border: 2px solid #D4AF37; border-radius: 5px; padding: 5px; transition: transform 0.2s; }"
-    "#size-dropdown:hover { transform: scale(1.05); }"
+    "#size-input { background: rgba(255, 255, 255, 0.1); color: white; border: 2px solid #D4AF37; border-radius: 5px; padding: 5px; transition: transform 0.2s; }"
+    "#size-input:hover { transform: scale(1.05); }"
     "#method-dropdown { background: rgba(255, 255, 255, 0.1); color: white; border: 2px solid #D4AF37; border-radius: 5px; padding: 5px; transition: transform 0.2s; }"
     "#method-dropdown:hover { transform: scale(1.05); }"
     "#generate-button { background: transparent; color: #D4AF37; border: 2px solid #D4AF37; border-radius: 25px; padding: 10px 20px; font-size: 16px; font-weight: bold; transition: transform 0.3s, background-color 0.3s; }"
     "#generate-button:hover { background-color: rgba(212, 175, 55, 0.1); transform: scale(1.1); }"
-    "#chess-grid { background: transparent; }"
-    "#grid-cell { background: #E6E6FA; min-width: 50px; min-height: 50px; transition: background-color 0.3s; }"
-    "#queen-cell { background: #000000; min-width: 50px; min-height: 50px; transition: background-color 0.3s; }"
     "#back-button { background: transparent; color: #FF0000; border: 2px solid #FF0000; border-radius: 25px; padding: 10px 20px; font-size: 16px; font-weight: bold; transition: transform 0.3s, background-color 0.3s; }"
     "#back-button:hover { background-color: rgba(255, 0, 0, 0.1); transform: scale(1.1); }"
     "#close-button { background: transparent; color: #FF0000; border: 2px solid #FF0000; border-radius: 25px; padding: 10px 20px; font-size: 16px; font-weight: bold; transition: transform 0.3s, background-color 0.3s; }"
@@ -395,6 +1788,7 @@ static void activate(GtkApplication *app, gpointer user_data) {
     "#nav-button:hover { background-color: rgba(212, 175, 55, 0.1); transform: scale(1.1); }"
     "#operation-label { color: #D4AF37; font-size: 18px; font-weight: bold; }"
     "#solution-count-label { color: #D4AF37; font-size: 18px; font-weight: bold; }"
+    "#stats-label { color: white; font-family: monospace; font-size: 14px; }"
     ".developer-card { "
     "  background: rgba(88, 28, 135, 0.3); "
     "  border-radius: 24px; "
@@ -406,18 +1800,12 @@ static void activate(GtkApplication *app, gpointer user_data) {
     gtk_style_context_add_provider_for_display(gdk_display_get_default(), GTK_STYLE_PROVIDER(provider), GTK_STYLE_PROVIDER_PRIORITY_APPLICATION);
 
     GtkWidget *overlay = gtk_overlay_new();
-    GtkWidget *drawing_area = gtk_drawing_area_new();
-
-    GError *error = NULL;
-    GdkPixbuf *pixbuf = gdk_pixbuf_new_from_file("background.png", &error);
-    if (error) {
-        g_warning("Failed to load background: %s", error->message);
-        g_error_free(error);
-    } else {
-        gtk_drawing_area_set_draw_func(GTK_DRAWING_AREA(drawing_area), draw_background, pixbuf, g_object_unref);
-    }
-
-    g_signal_connect(drawing_area, "resize", G_CALLBACK(gtk_widget_queue_draw), NULL);
+    /* The background texture is stretched by the renderer, so resizing never rescales
+     * the image on the CPU. */
+    GtkWidget *background = gtk_picture_new();
+    gtk_picture_set_content_fit(GTK_PICTURE(background), GTK_CONTENT_FIT_FILL);
+    gtk_picture_set_can_shrink(GTK_PICTURE(background), TRUE);
+    asset_load("background.png", 0, set_picture_texture, background);
 
     GtkWidget *stack = gtk_stack_new();
     gtk_stack_set_transition_type(GTK_STACK(stack), GTK_STACK_TRANSITION_TYPE_SLIDE_LEFT_RIGHT);
@@ -425,8 +1813,9 @@ static void activate(GtkApplication *app, gpointer user_data) {
     GtkWidget *main_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 0);
     GtkWidget *top_bar = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 0);
     gtk_widget_set_halign(top_bar, GTK_ALIGN_END);
-    GtkWidget *logo_image = gtk_image_new_from_file("logo.png");
+    GtkWidget *logo_image = gtk_image_new();
     gtk_image_set_pixel_size(GTK_IMAGE(logo_image), 150);
+    asset_load("logo.png", 150, set_image_texture, logo_image);
     gtk_box_append(GTK_BOX(top_bar), logo_image);
     gtk_widget_set_margin_top(top_bar, 10);
     gtk_widget_set_margin_end(top_bar, 10);
@@ -483,23 +1872,23 @@ static void activate(GtkApplication *app, gpointer user_data) {
     GtkWidget *input_box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 10);
     gtk_widget_set_halign(input_box, GTK_ALIGN_CENTER);
 
-    GtkWidget *size_label = gtk_label_new("Taille de la grille (3-10):");
+    GtkWidget *size_label = gtk_label_new("Taille de la grille:");
     gtk_widget_set_name(size_label, "input-label");
 
-    GtkStringList *size_list = gtk_string_list_new(NULL);
-    for (int i = 3; i <= 10; i++) {
-        char buffer[10];
-        snprintf(buffer, sizeof(buffer), "%d", i);
-        gtk_string_list_append(size_list, buffer);
-    }
-
-    GtkWidget *size_dropdown = gtk_drop_down_new(G_LIST_MODEL(size_list), NULL);
-    gtk_widget_set_name(size_dropdown, "size-dropdown");
+    GtkWidget *size_spin = gtk_spin_button_new_with_range(1, MIN_CONFLICTS_MAX_SIZE, 1);
+    gtk_spin_button_set_value(GTK_SPIN_BUTTON(size_spin), 8);
+    gtk_widget_set_name(size_spin, "size-input");
 
     GtkStringList *method_list = gtk_string_list_new(NULL);
     gtk_string_list_append(method_list, "Recherche intuitive");
     gtk_string_list_append(method_list, "Exploration arborescente");
     gtk_string_list_append(method_list, "Exploration exhaustive");
+    gtk_string_list_append(method_list, "Recherche par bitmasks");
+    gtk_string_list_append(method_list, "Comptage parallèle");
+    gtk_string_list_append(method_list, "Recherche par symétries");
+    gtk_string_list_append(method_list, "Min-conflits (grands n)");
+    gtk_string_list_append(method_list, "Dancing Links (DLX)");
+    gtk_string_list_append(method_list, "Comptage vectoriel (SIMD)");
 
     GtkWidget *method_dropdown = gtk_drop_down_new(G_LIST_MODEL(method_list), NULL);
     gtk_widget_set_name(method_dropdown, "method-dropdown");
@@ -507,16 +1896,32 @@ static void activate(GtkApplication *app, gpointer user_data) {
     GtkWidget *generate_button = gtk_button_new_with_label("Générer la grille");
     gtk_widget_set_name(generate_button, "generate-button");
 
+    GtkWidget *cancel_button = gtk_button_new_with_label("Annuler");
+    gtk_widget_set_name(cancel_button, "back-button");
+    gtk_widget_set_sensitive(cancel_button, FALSE);
+
     gtk_box_append(GTK_BOX(input_box), size_label);
-    gtk_box_append(GTK_BOX(input_box), size_dropdown);
+    gtk_box_append(GTK_BOX(input_box), size_spin);
     gtk_box_append(GTK_BOX(input_box), method_dropdown);
+    GtkWidget *lazy_check = gtk_check_button_new_with_label("Solutions à la demande");
+    gtk_widget_set_name(lazy_check, "input-label");
+
+    gtk_box_append(GTK_BOX(input_box), lazy_check);
+    GtkWidget *edit_check = gtk_check_button_new_with_label("Placer / bloquer des cases");
+    gtk_widget_set_name(edit_check, "input-label");
+    gtk_box_append(GTK_BOX(input_box), edit_check);
     gtk_box_append(GTK_BOX(input_box), generate_button);
+    gtk_box_append(GTK_BOX(input_box), cancel_button);
 
     GtkWidget *grid_container = gtk_box_new(GTK_ORIENTATION_VERTICAL, 10);
     gtk_widget_set_halign(grid_container, GTK_ALIGN_CENTER);
     gtk_widget_set_valign(grid_container, GTK_ALIGN_CENTER);
     gtk_widget_set_vexpand(grid_container, TRUE);
 
+    GtkWidget *board_area = gtk_drawing_area_new();
+    gtk_widget_set_size_request(board_area, 500, 500);
+    gtk_box_append(GTK_BOX(grid_container), board_area);
+
     GtkWidget *nav_box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 10);
     gtk_widget_set_halign(nav_box, GTK_ALIGN_CENTER);
 
@@ -534,9 +1939,47 @@ static void activate(GtkApplication *app, gpointer user_data) {
 
     gtk_box_append(GTK_BOX(nav_box), prev_button);
     gtk_box_append(GTK_BOX(nav_box), next_button);
+    GtkWidget *jump_spin = gtk_spin_button_new_with_range(1, 1e15, 1);
+    gtk_widget_set_name(jump_spin, "size-input");
+
+    GtkWidget *jump_button = gtk_button_new_with_label("Aller à la solution");
+    gtk_widget_set_name(jump_button, "nav-button");
+
+    gtk_box_append(GTK_BOX(nav_box), jump_spin);
+    gtk_box_append(GTK_BOX(nav_box), jump_button);
     gtk_box_append(GTK_BOX(nav_box), operation_label);
     gtk_box_append(GTK_BOX(nav_box), solution_count_label);
 
+    GtkWidget *progress_label = gtk_label_new("");
+    gtk_widget_set_name(progress_label, "operation-label");
+    gtk_widget_set_halign(progress_label, GTK_ALIGN_CENTER);
+
+    GtkWidget *stats_label = gtk_label_new("");
+    gtk_widget_set_name(stats_label, "stats-label");
+    gtk_label_set_xalign(GTK_LABEL(stats_label), 0.0f);
+    gtk_label_set_selectable(GTK_LABEL(stats_label), TRUE);
+
+    GtkWidget *export_csv_button = gtk_button_new_with_label("Exporter CSV");
+    gtk_widget_set_name(export_csv_button, "nav-button");
+    GtkWidget *export_json_button = gtk_button_new_with_label("Exporter JSON");
+    gtk_widget_set_name(export_json_button, "nav-button");
+    GtkWidget *stats_export_label = gtk_label_new("");
+    gtk_widget_set_name(stats_export_label, "stats-label");
+
+    GtkWidget *export_box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 10);
+    gtk_box_append(GTK_BOX(export_box), export_csv_button);
+    gtk_box_append(GTK_BOX(export_box), export_json_button);
+    gtk_box_append(GTK_BOX(export_box), stats_export_label);
+
+    GtkWidget *stats_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 10);
+    gtk_box_append(GTK_BOX(stats_box), stats_label);
+    gtk_box_append(GTK_BOX(stats_box), export_box);
+
+    GtkWidget *stats_expander = gtk_expander_new("Statistiques");
+    gtk_widget_set_name(stats_expander, "input-label");
+    gtk_widget_set_halign(stats_expander, GTK_ALIGN_CENTER);
+    gtk_expander_set_child(GTK_EXPANDER(stats_expander), stats_box);
+
     GtkWidget *back_button = gtk_button_new_with_label("RETOUR");
     gtk_widget_set_name(back_button, "back-button");
     gtk_widget_set_halign(back_button, GTK_ALIGN_START);
@@ -545,63 +1988,20 @@ static void activate(GtkApplication *app, gpointer user_data) {
     gtk_box_append(GTK_BOX(solver_box), input_box);
     gtk_box_append(GTK_BOX(solver_box), grid_container);
     gtk_box_append(GTK_BOX(solver_box), nav_box);
+    gtk_box_append(GTK_BOX(solver_box), progress_label);
+    gtk_box_append(GTK_BOX(solver_box), stats_expander);
     gtk_box_append(GTK_BOX(solver_box), back_button);
 
     gtk_stack_add_named(GTK_STACK(stack), solver_box, "solver");
 
-    GtkWidget *about_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 30);
-    gtk_widget_set_margin_start(about_box, 40);
-    gtk_widget_set_margin_end(about_box, 40);
-    gtk_widget_set_margin_top(about_box, 40);
-    gtk_widget_set_margin_bottom(about_box, 40);
-
-    GtkWidget *about_title = gtk_label_new(NULL);
-    gtk_label_set_markup(GTK_LABEL(about_title), "<span font='48' weight='bold' foreground='#fde68a'>Developers</span>");
-    gtk_widget_set_margin_bottom(about_title, 40);
-    gtk_box_append(GTK_BOX(about_box), about_title);
-
-    GtkWidget *cards_box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 20);
-    gtk_widget_set_halign(cards_box, GTK_ALIGN_CENTER);
-    gtk_widget_set_margin_top(cards_box, 40);
-
-    const char *developers[][3] = {
-        {"HASSOUNE ZAKARIA", "TESTER DEVELOPERS", "avatar1.png"},
-        {"AZOUGEN ZINEB", "TESTER DEVELOPERS", "avatar2.png"},
-        {"OUKHRID MOHAMED AMINE", "DESIGNER DEVELOPERS", "avatar3.png"},
-        {"ABOUHAFSS OUSSAMA", "SCRUM MA DEVELOPERS", "avatar4.png"},
-        {"AZEMRAY OUALID", "TESTER DEVELOPERS", "avatar5.png"}
-    };
-
-    for (int i = 0; i < 5; i++) {
-        GtkWidget *card = create_developer_card(
-            developers[i][0], 
-            developers[i][1],
-            developers[i][2]
-        );
-        gtk_box_append(GTK_BOX(cards_box), card);
-    }
-    gtk_box_append(GTK_BOX(about_box), cards_box);
-
-    GtkWidget *back_button_about = gtk_button_new_with_label("BACK");
-    gtk_widget_set_name(back_button_about, "back-button");
-    gtk_widget_set_halign(back_button_about, GTK_ALIGN_START);
-    gtk_widget_set_valign(back_button_about, GTK_ALIGN_END);
-    gtk_widget_set_margin_start(back_button_about, 20);
-    gtk_widget_set_margin_bottom(back_button_about, 20);
-    gtk_box_append(GTK_BOX(about_box), back_button_about);
-    g_signal_connect(back_button_about, "clicked", G_CALLBACK(switch_to_main_menu), stack);
-
-    // Add the about_box directly to the stack
-    gtk_stack_add_named(GTK_STACK(stack), about_box, "about");
-
-    gtk_overlay_set_child(GTK_OVERLAY(overlay), drawing_area);
+    gtk_overlay_set_child(GTK_OVERLAY(overlay), background);
     gtk_overlay_add_overlay(GTK_OVERLAY(overlay), stack);
 
     gtk_window_set_child(GTK_WINDOW(window), overlay);
 
     GridData *grid_data = g_new(GridData, 1);
-    grid_data->grid = NULL;
-    grid_data->size_dropdown = size_dropdown;
+    board_view_attach(&grid_data->board, board_area);
+    grid_data->size_spin = size_spin;
     grid_data->generate_button = generate_button;
     grid_data->grid_container = grid_container;
     grid_data->prev_button = prev_button;
@@ -609,28 +2009,62 @@ static void activate(GtkApplication *app, gpointer user_data) {
     grid_data->operation_label = operation_label;
     grid_data->solution_count_label = solution_count_label;
     grid_data->method_dropdown = method_dropdown;
+    grid_data->cancel_button = cancel_button;
+    grid_data->progress_label = progress_label;
     grid_data->overlay = overlay;
+    grid_data->jump_spin = jump_spin;
+    grid_data->lazy_check = lazy_check;
+    grid_data->edit_check = edit_check;
+    grid_data->editing = false;
+    grid_data->completion_job = NULL;
+    board_constraints_reset(&grid_data->constraints, 0);
+    grid_data->stats_label = stats_label;
+    grid_data->stats_export_label = stats_export_label;
     grid_data->current_size = 0;
-    grid_data->solutions = NULL;
+    grid_data->current_method = METHOD_BITBOARD;
+    grid_data->solutions = (SolutionStore){0};
+    grid_data->solve_job = NULL;
+    grid_data->jump_job = NULL;
+    grid_data->drain_timer_id = 0;
+    grid_data->solve_start_us = 0;
     grid_data->solution_count = 0;
     grid_data->current_solution_index = 0;
+    grid_data->current_symmetry = 0;
+    grid_data->symmetry_reduced = false;
+    grid_data->index = (SolutionIndex){0};
+    grid_data->indexed_browsing = false;
+    grid_data->current_rank = 0;
+    grid_data->lazy_browsing = false;
+    grid_data->iterator_idle_id = 0;
     grid_data->operation_count = 0;
-    grid_data->thread_running = false;
+    grid_data->stats = (SolverStats){0};
     grid_data->animation_running = false;
     grid_data->animation_timer_id = 0;
 
     g_signal_connect(generate_button, "clicked", G_CALLBACK(generate_grid), grid_data);
+    g_signal_connect(cancel_button, "clicked", G_CALLBACK(cancel_solve), grid_data);
     g_signal_connect(prev_button, "clicked", G_CALLBACK(show_previous_solution), grid_data);
     g_signal_connect(next_button, "clicked", G_CALLBACK(show_next_solution), grid_data);
+    g_signal_connect(jump_button, "clicked", G_CALLBACK(jump_to_solution), grid_data);
+    g_signal_connect(edit_check, "toggled", G_CALLBACK(toggle_editing), grid_data);
+    g_signal_connect(size_spin, "value-changed", G_CALLBACK(size_changed), grid_data);
+    GtkGesture *board_click = gtk_gesture_click_new();
+    g_signal_connect(board_click, "released", G_CALLBACK(board_clicked), grid_data);
+    gtk_widget_add_controller(board_area, GTK_EVENT_CONTROLLER(board_click));
+    g_signal_connect(export_csv_button, "clicked", G_CALLBACK(export_stats_csv), grid_data);
+    g_signal_connect(export_json_button, "clicked", G_CALLBACK(export_stats_json), grid_data);
 
     gtk_window_present(GTK_WINDOW(window));
 }
 
 int main(int argc, char **argv) {
+    int cli_status = run_cli(argc, argv);
+    if (cli_status >= 0) return cli_status;
+
     GtkApplication *app = gtk_application_new("com.example.solver", G_APPLICATION_DEFAULT_FLAGS);
     g_signal_connect(app, "activate", G_CALLBACK(activate), NULL);
     int status = g_application_run(G_APPLICATION(app), argc, argv);
     g_object_unref(app);
 
     return status;
-}
\ No newline at end of file
+}
@@ -0,0 +1,2177 @@
+/* libnqueens: the solving and counting engines, and the stable API of nqueens.h on
+ * top of them. Nothing here depends on GTK. */
+#include "nqueens.h"
+#include "nqueens_internal.h"
+#include <pthread.h>
+#include <time.h>
+#include <limits.h>
+#include <math.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HAVE_X86_SIMD 1
+#endif
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#define SOLUTION_STORE_MAX_BYTES (64u << 20)
+#define PARALLEL_TASKS_PER_THREAD 32
+#define SOLUTION_BATCH_SIZE 4096
+#define STREAM_FLUSH_INTERVAL_NS 20000000ull
+#define STREAM_POLL_OPERATIONS 4096
+#define SEARCH_SNAPSHOT_INTERVAL_NS 10000000ull
+#define CANCEL_CHECK_MASK 0x3fff
+#define PARALLEL_POLL_INTERVAL_NS 10000000
+#define SOLUTION_BATCH_BYTES (1u << 20)
+#define MIN_CONFLICTS_SAMPLES 16
+#define MIN_CONFLICTS_INIT_ATTEMPTS 64
+#define MIN_CONFLICTS_RANDOM_TAIL 32
+#define MIN_CONFLICTS_MAX_RESTARTS 100
+#define MIN_CONFLICTS_DEFAULT_SEED 0x9e3779b97f4a7c15ull
+#define UNRANK_CACHE_DEPTH 4
+#define LOCKSTEP_MIN_SIZE 6
+#define LOCKSTEP_TASKS_PER_LANE 64
+#define LOCKSTEP_BLOCK_STEPS 32
+#define LOCKSTEP_POLL_BLOCKS 1024
+#define ITERATOR_SLICE (1 << 18)
+
+/* Names used by the command line, in dropdown order. */
+const char *method_names[METHOD_COUNT] = {
+    "intuitive",
+    "arborescent",
+    "exhaustive",
+    "bitboard",
+    "parallel",
+    "symmetric",
+    "minconflicts",
+    "dlx",
+    "lockstep"
+};
+
+/* Seed for the randomised engines; --seed overrides it so runs can be reproduced. */
+uint64_t solver_seed = MIN_CONFLICTS_DEFAULT_SEED;
+
+typedef struct {
+    int n;
+    uint32_t all;
+    unsigned char placement[BITBOARD_MAX_SIZE];
+    SolverOutput *out;
+} BitboardSearch;
+
+typedef struct {
+    PrefixTask *tasks;
+    int head;
+    int tail;
+    pthread_mutex_t lock;
+} TaskDeque;
+
+typedef struct ParallelCounter ParallelCounter;
+
+typedef struct {
+    ParallelCounter *counter;
+    int index;
+    pthread_t thread;
+    atomic_llong solutions;
+    atomic_llong operations;
+    pthread_mutex_t stats_lock;
+    SolverStats stats; /* snapshot after the worker's last finished task */
+} CounterWorker;
+
+struct ParallelCounter {
+    uint32_t all;
+    CountKernel kernel;
+    int worker_count;
+    TaskDeque *deques;
+    CounterWorker *workers;
+    const atomic_bool *cancel;
+    atomic_int tasks_done;
+};
+
+/* Empties the store for a new run of size n, keeping the arena allocated. */
+void solution_store_reset(SolutionStore *store, int n) {
+    store->count = 0;
+    store->mapped = NULL;
+    store->truncated = false;
+    store->n = n;
+    store->width = placement_width(n);
+    store->stride = (size_t)n * store->width;
+    store->limit = SOLUTION_STORE_MAX_BYTES / store->stride;
+}
+
+bool solution_store_append(SolutionStore *store, const void *placement) {
+    if (store->mapped) return false;
+    if (store->count >= store->limit) {
+        store->truncated = true;
+        return false;
+    }
+
+    size_t needed = (store->count + 1) * store->stride;
+    if (needed > store->capacity) {
+        size_t capacity = store->capacity ? store->capacity : 16384;
+        while (capacity < needed) capacity *= 2;
+        if (capacity > SOLUTION_STORE_MAX_BYTES) capacity = SOLUTION_STORE_MAX_BYTES;
+        unsigned char *data = realloc(store->data, capacity);
+        if (!data) {
+            store->truncated = true;
+            return false;
+        }
+        store->data = data;
+        store->capacity = capacity;
+    }
+
+    memcpy(store->data + store->count * store->stride, placement, store->stride);
+    store->count++;
+    return true;
+}
+
+const unsigned char *solution_store_get(const SolutionStore *store, size_t index) {
+    return (store->mapped ? store->mapped : store->data) + index * store->stride;
+}
+
+int solution_store_row(const SolutionStore *store, size_t index, int col) {
+    return placement_row(solution_store_get(store, index), store->width, col);
+}
+
+uint64_t monotonic_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec;
+}
+
+bool solution_queue_push(SolutionQueue *queue, SolutionBatch *batch) {
+    size_t tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    size_t head = atomic_load_explicit(&queue->head, memory_order_acquire);
+    if (tail - head == SOLUTION_QUEUE_SLOTS) return false;
+
+    queue->slots[tail % SOLUTION_QUEUE_SLOTS] = batch;
+    atomic_store_explicit(&queue->tail, tail + 1, memory_order_release);
+    return true;
+}
+
+SolutionBatch *solution_queue_pop(SolutionQueue *queue) {
+    size_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    size_t tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+    if (head == tail) return NULL;
+
+    SolutionBatch *batch = queue->slots[head % SOLUTION_QUEUE_SLOTS];
+    atomic_store_explicit(&queue->head, head + 1, memory_order_release);
+    return batch;
+}
+
+/* Small boards preallocate a full batch; wide placements start with room for as many
+ * as fit in SOLUTION_BATCH_BYTES and grow on demand. */
+static SolutionBatch *solution_batch_new(size_t stride) {
+    SolutionBatch *batch = calloc(1, sizeof(SolutionBatch));
+    size_t capacity = SOLUTION_BATCH_BYTES / stride;
+    if (capacity < 1) capacity = 1;
+    if (capacity > SOLUTION_BATCH_SIZE) capacity = SOLUTION_BATCH_SIZE;
+    batch->capacity = (int)capacity;
+    batch->placements = malloc(capacity * stride);
+    return batch;
+}
+
+void solution_batch_free(SolutionBatch *batch) {
+    free(batch->placements);
+    free(batch);
+}
+
+void solver_output_init(SolverOutput *out, SolutionQueue *queue, int n) {
+    out->queue = queue;
+    out->pending = NULL;
+    out->dump = NULL;
+    out->dump_label = NULL;
+    out->sink = NULL;
+    out->sink_data = NULL;
+    out->snapshot = NULL;
+    out->trace_placement = NULL;
+    out->trace_depth = 0;
+    out->last_snapshot_ns = 0;
+    out->n = n;
+    out->width = placement_width(n);
+    out->stride = (size_t)n * out->width;
+    out->solution_count = 0;
+    out->operation_count = 0;
+    memset(&out->stats, 0, sizeof(out->stats));
+    out->start_ns = monotonic_ns();
+    out->poll_countdown = STREAM_POLL_OPERATIONS;
+    out->first_published = false;
+    out->last_flush_ns = out->start_ns;
+    out->cancel = NULL;
+    out->detached = NULL;
+    out->stopped = false;
+    for (int d = 0; d < PROGRESS_DEPTH; d++) {
+        out->branch_index[d] = 0;
+        out->branch_count[d] = 1;
+    }
+}
+
+/* Engines report which branch they are on for the first PROGRESS_DEPTH levels; the
+ * completed fraction of the tree is read off those like digits of a mixed-radix number. */
+static inline void solver_output_branch(SolverOutput *out, int depth, int index, int count) {
+    if (depth >= PROGRESS_DEPTH) return;
+    out->branch_index[depth] = index;
+    out->branch_count[depth] = count > 0 ? count : 1;
+    for (int d = depth + 1; d < PROGRESS_DEPTH; d++) {
+        out->branch_index[d] = 0;
+        out->branch_count[d] = 1;
+    }
+}
+
+double solver_output_progress(const SolverOutput *out) {
+    double progress = 0.0;
+    double scale = 1.0;
+    for (int d = 0; d < PROGRESS_DEPTH; d++) {
+        scale /= out->branch_count[d];
+        progress += out->branch_index[d] * scale;
+    }
+    return progress;
+}
+
+void solver_stats_merge(SolverStats *into, const SolverStats *from) {
+    for (int c = 0; c < BITBOARD_MAX_SIZE; c++) into->nodes[c] += from->nodes[c];
+    into->pruned += from->pruned;
+    into->leaves += from->leaves;
+    into->updates += from->updates;
+    into->solutions += from->solutions;
+    for (int p = 0; p < SOLVER_PHASE_COUNT; p++) into->phase_ns[p] += from->phase_ns[p];
+}
+
+/* Copies the run's statistics as of now; search time is whatever the run did not
+ * spend in setup or publishing. */
+void solver_output_snapshot_stats(const SolverOutput *out, SolverStats *stats) {
+    *stats = out->stats;
+    stats->solutions = out->solution_count;
+    uint64_t elapsed = monotonic_ns() - out->start_ns;
+    uint64_t other = stats->phase_ns[SOLVER_PHASE_SETUP] + stats->phase_ns[SOLVER_PHASE_PUBLISH];
+    stats->phase_ns[SOLVER_PHASE_SEARCH] = elapsed > other ? elapsed - other : 0;
+}
+
+static const char *const solver_phase_names[SOLVER_PHASE_COUNT] = {"setup", "search", "publish"};
+
+/* One JSON object, no trailing newline, so it can be embedded in a larger record. */
+void write_stats_json(FILE *file, const SolverStats *stats, int n) {
+    fputs("{\"nodes\":[", file);
+    for (int c = 0; c < MIN(n, BITBOARD_MAX_SIZE); c++) fprintf(file, c ? ",%lld" : "%lld", stats->nodes[c]);
+    fprintf(file, "],\"pruned\":%lld,\"leaves\":%lld,\"updates\":%lld,\"solutions\":%lld,\"phase_ns\":{",
+            stats->pruned, stats->leaves, stats->updates, stats->solutions);
+    for (int p = 0; p < SOLVER_PHASE_COUNT; p++) {
+        fprintf(file, "%s\"%s\":%llu", p ? "," : "", solver_phase_names[p], (unsigned long long)stats->phase_ns[p]);
+    }
+    fputs("}}", file);
+}
+
+/* metric,column,value rows; column is empty for whole-run metrics. */
+void write_stats_csv(FILE *file, const SolverStats *stats, int n) {
+    fputs("metric,column,value\n", file);
+    for (int c = 0; c < MIN(n, BITBOARD_MAX_SIZE); c++) fprintf(file, "nodes,%d,%lld\n", c, stats->nodes[c]);
+    fprintf(file, "pruned,,%lld\nleaves,,%lld\nupdates,,%lld\nsolutions,,%lld\n",
+            stats->pruned, stats->leaves, stats->updates, stats->solutions);
+    for (int p = 0; p < SOLVER_PHASE_COUNT; p++) {
+        fprintf(file, "%s_ns,,%llu\n", solver_phase_names[p], (unsigned long long)stats->phase_ns[p]);
+    }
+}
+
+/* Hands the pending batch to the consumer. A full queue leaves it pending so the
+ * solver keeps running; only the final batch waits for room, unless the consumer
+ * has detached and will never make any. */
+static void solver_output_flush(SolverOutput *out, bool finished) {
+    if (!out->queue) return;
+    uint64_t flush_start = monotonic_ns();
+    if (!out->pending) out->pending = solution_batch_new(out->stride);
+
+    SolutionBatch *batch = out->pending;
+    batch->solution_count = out->solution_count;
+    batch->operation_count = out->operation_count;
+    solver_output_snapshot_stats(out, &batch->stats);
+    batch->progress = (finished && !out->stopped) ? 1.0 : solver_output_progress(out);
+    batch->finished = finished;
+    batch->cancelled = out->stopped;
+    bool has_solutions = batch->count > 0; /* the consumer owns the batch once it is pushed */
+
+    while (!solution_queue_push(out->queue, batch)) {
+        if (!finished || (out->detached && atomic_load_explicit(out->detached, memory_order_relaxed))) {
+            out->stats.phase_ns[SOLVER_PHASE_PUBLISH] += monotonic_ns() - flush_start;
+            return;
+        }
+        struct timespec pause = {0, 1000000};
+        nanosleep(&pause, NULL);
+    }
+
+    out->pending = NULL;
+    out->first_published = out->first_published || has_solutions;
+    out->last_flush_ns = monotonic_ns();
+    out->stats.phase_ns[SOLVER_PHASE_PUBLISH] += out->last_flush_ns - flush_start;
+}
+
+void search_snapshot_init(SearchSnapshot *snapshot) {
+    memset(snapshot->frames, 0, sizeof(snapshot->frames));
+    atomic_init(&snapshot->sequence[0], 0);
+    atomic_init(&snapshot->sequence[1], 0);
+    atomic_init(&snapshot->published, 0);
+}
+
+static void search_snapshot_publish(SolverOutput *out) {
+    SearchSnapshot *snapshot = out->snapshot;
+    unsigned published = atomic_load_explicit(&snapshot->published, memory_order_relaxed);
+    int index = published & 1;
+    unsigned sequence = atomic_load_explicit(&snapshot->sequence[index], memory_order_relaxed);
+    atomic_store_explicit(&snapshot->sequence[index], sequence + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    SearchFrame *frame = &snapshot->frames[index];
+    frame->depth = out->trace_placement ? out->trace_depth : 0;
+    memcpy(frame->placement, out->trace_placement ? out->trace_placement : frame->placement, frame->depth);
+    memcpy(frame->nodes, out->stats.nodes, sizeof(frame->nodes));
+
+    atomic_store_explicit(&snapshot->sequence[index], sequence + 2, memory_order_release);
+    atomic_store_explicit(&snapshot->published, published + 1, memory_order_release);
+}
+
+/* Copies the newest frame; false when none has been published yet or the solver kept
+ * overwriting it, in which case the caller simply tries again on its next frame. */
+bool search_snapshot_read(SearchSnapshot *snapshot, SearchFrame *frame) {
+    for (int attempt = 0; attempt < 4; attempt++) {
+        unsigned published = atomic_load_explicit(&snapshot->published, memory_order_acquire);
+        if (published == 0) return false;
+        int index = (published - 1) & 1;
+        unsigned before = atomic_load_explicit(&snapshot->sequence[index], memory_order_acquire);
+        if (before & 1) continue;
+        memcpy(frame, &snapshot->frames[index], sizeof(*frame));
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&snapshot->sequence[index], memory_order_relaxed) == before) return true;
+    }
+    return false;
+}
+
+/* Runs every STREAM_POLL_OPERATIONS operations, so the snapshot costs the search one
+ * predictable branch there when disabled and a frame copy per interval when enabled. */
+void solver_output_poll(SolverOutput *out) {
+    out->poll_countdown = STREAM_POLL_OPERATIONS;
+    if (out->cancel && atomic_load_explicit(out->cancel, memory_order_relaxed)) {
+        out->stopped = true;
+    }
+    uint64_t now = monotonic_ns();
+    if (out->snapshot && now - out->last_snapshot_ns >= SEARCH_SNAPSHOT_INTERVAL_NS) {
+        search_snapshot_publish(out);
+        out->last_snapshot_ns = now;
+    }
+    if (now - out->last_flush_ns >= STREAM_FLUSH_INTERVAL_NS) {
+        solver_output_flush(out, false);
+    }
+}
+
+static inline void solver_output_count_operation(SolverOutput *out) {
+    out->operation_count++;
+    if (--out->poll_countdown == 0) solver_output_poll(out);
+}
+
+/* An operation that places a queen in column col of a search tree; columns before it
+ * are the engine's current partial board. */
+static inline void solver_output_count_node(SolverOutput *out, int col) {
+    out->stats.nodes[col]++;
+    out->operation_count++;
+    if (--out->poll_countdown == 0) {
+        out->trace_depth = col;
+        solver_output_poll(out);
+    }
+}
+
+static void dump_placement(SolverOutput *out, const unsigned char *placement) {
+    fprintf(out->dump, "{\"n\":%d,\"method\":\"%s\",\"solution\":[", out->n, out->dump_label);
+    for (int j = 0; j < out->n; j++) {
+        fprintf(out->dump, j ? ",%d" : "%d", placement_row(placement, out->width, j));
+    }
+    fputs("]}\n", out->dump);
+}
+
+/* placement holds out->n rows of out->width bytes each: unsigned char rows for the
+ * exact engines, uint32_t rows once n exceeds 256. */
+void solver_output_emit(SolverOutput *out, const void *placement) {
+    if (out->dump) dump_placement(out, placement);
+    if (out->sink && !out->sink(out->sink_data, placement)) out->stopped = true;
+    if (!out->queue) return;
+
+    if (!out->pending) out->pending = solution_batch_new(out->stride);
+
+    SolutionBatch *batch = out->pending;
+    if (batch->count == batch->capacity) {
+        batch->capacity *= 2;
+        batch->placements = realloc(batch->placements, (size_t)batch->capacity * out->stride);
+    }
+    memcpy(batch->placements + (size_t)batch->count * out->stride, placement, out->stride);
+    batch->count++;
+
+    if (!out->first_published || batch->count >= SOLUTION_BATCH_SIZE) {
+        solver_output_flush(out, false);
+    }
+}
+
+void solver_output_finish(SolverOutput *out) {
+    solver_output_flush(out, true);
+    if (out->pending) {
+        solution_batch_free(out->pending);
+        out->pending = NULL;
+    }
+}
+
+static void board_to_placement(int **board, int n, unsigned char *placement) {
+    for (int j = 0; j < n; j++) {
+        for (int i = 0; i < n; i++) {
+            if (board[i][j]) placement[j] = i;
+        }
+    }
+}
+
+bool is_safe(int **board, int row, int col, int n) {
+    for (int i = 0; i < col; i++) {
+        if (board[row][i]) return false;
+    }
+    for (int i = row, j = col; i >= 0 && j >= 0; i--, j--) {
+        if (board[i][j]) return false;
+    }
+    for (int i = row, j = col; i < n && j >= 0; i++, j--) {
+        if (board[i][j]) return false;
+    }
+    return true;
+}
+
+/* Diagonal occupancy for a full row permutation. conflicts counts the queens beyond the
+ * first on every diagonal, so the placement is a solution exactly when it is zero. */
+typedef struct {
+    int n;
+    int *rising;
+    int *falling;
+    int conflicts;
+} DiagonalState;
+
+static void diagonal_place(DiagonalState *state, int row, int col, int delta) {
+    int *rising = &state->rising[row + col];
+    int *falling = &state->falling[row - col + state->n - 1];
+    if (delta < 0) {
+        state->conflicts -= (*rising >= 2) + (*falling >= 2);
+        (*rising)--;
+        (*falling)--;
+    } else {
+        state->conflicts += (*rising >= 1) + (*falling >= 1);
+        (*rising)++;
+        (*falling)++;
+    }
+}
+
+static void swap_columns(DiagonalState *state, unsigned char *placement, int a, int b) {
+    diagonal_place(state, placement[a], a, -1);
+    diagonal_place(state, placement[b], b, -1);
+    unsigned char row = placement[a];
+    placement[a] = placement[b];
+    placement[b] = row;
+    diagonal_place(state, placement[a], a, +1);
+    diagonal_place(state, placement[b], b, +1);
+}
+
+static void check_permutation(DiagonalState *state, const unsigned char *placement, SolverOutput *out) {
+    solver_output_count_operation(out);
+    out->stats.leaves++;
+    if (state->conflicts == 0) {
+        out->solution_count++;
+        solver_output_emit(out, placement);
+    } else {
+        out->stats.pruned++;
+    }
+}
+
+/* Exhaustive mode: visits every one of the n! row permutations with Heap's algorithm.
+ * Consecutive permutations differ by a single swap, so the diagonal state is updated
+ * for the two moved queens instead of revalidating the whole board. */
+void generate_all_configurations(int n, SolverOutput *out) {
+    if (n < 1 || n > BITBOARD_MAX_SIZE) return;
+
+    unsigned char placement[BITBOARD_MAX_SIZE] = {0};
+    int counters[BITBOARD_MAX_SIZE] = {0};
+    DiagonalState state;
+    state.n = n;
+    state.rising = calloc(2 * n - 1, sizeof(int));
+    state.falling = calloc(2 * n - 1, sizeof(int));
+    state.conflicts = 0;
+
+    for (int c = 0; c < n; c++) {
+        placement[c] = c;
+        diagonal_place(&state, c, c, +1);
+    }
+    check_permutation(&state, placement, out);
+    out->trace_placement = placement;
+    out->trace_depth = n;
+
+    int i = 1;
+    while (i < n && !out->stopped) {
+        if (counters[i] < i) {
+            swap_columns(&state, placement, (i % 2 == 0) ? 0 : counters[i], i);
+            check_permutation(&state, placement, out);
+            counters[i]++;
+            if (i == n - 1) solver_output_branch(out, 0, counters[i], n);
+            if (i == n - 2) solver_output_branch(out, 1, counters[i], n - 1);
+            i = 1;
+        } else {
+            counters[i] = 0;
+            i++;
+        }
+    }
+    out->trace_placement = NULL;
+
+    free(state.rising);
+    free(state.falling);
+}
+
+bool solve_n_queens_intuitive(int **board, int col, int n, SolverOutput *out) {
+    if (col == n) {
+        out->stats.leaves++;
+        return true;
+    }
+    for (int i = 0; i < n && !out->stopped; i++) {
+        solver_output_branch(out, col, i, n);
+        solver_output_count_operation(out);
+        if (is_safe(board, i, col, n)) {
+            out->stats.nodes[col]++;
+            board[i][col] = 1;
+            if (solve_n_queens_intuitive(board, col + 1, n, out)) {
+                return true;
+            }
+            board[i][col] = 0;
+        } else {
+            out->stats.pruned++;
+        }
+    }
+    return false;
+}
+
+/* Leaves of the arborescent search are validated VALIDATE_BATCH at a time. The batch
+ * is transposed so that lane k of column c holds candidate k's row in that column; two
+ * columns a < b conflict in a lane when |row_a - row_b| is 0 or b - a. */
+typedef void (*ValidateKernel)(const unsigned char *candidates, int count, int n, unsigned char *valid);
+
+static void transpose_candidates(const unsigned char *candidates, int count, int n,
+                                 unsigned char lanes[][VALIDATE_BATCH]) {
+    for (int c = 0; c < n; c++) {
+        for (int k = 0; k < VALIDATE_BATCH; k++) {
+            lanes[c][k] = (k < count) ? candidates[k * n + c] : 0;
+        }
+    }
+}
+
+static void validate_candidates_scalar(const unsigned char *candidates, int count, int n, unsigned char *valid) {
+    for (int k = 0; k < count; k++) {
+        const unsigned char *rows = candidates + k * n;
+        bool ok = true;
+        for (int a = 0; a < n && ok; a++) {
+            for (int b = a + 1; b < n; b++) {
+                int distance = abs(rows[a] - rows[b]);
+                if (distance == 0 || distance == b - a) {
+                    ok = false;
+                    break;
+                }
+            }
+        }
+        valid[k] = ok;
+    }
+}
+
+#ifdef HAVE_X86_SIMD
+__attribute__((target("sse2")))
+static void validate_candidates_sse2(const unsigned char *candidates, int count, int n, unsigned char *valid) {
+    unsigned char lanes[BITBOARD_MAX_SIZE][VALIDATE_BATCH];
+    transpose_candidates(candidates, count, n, lanes);
+
+    for (int half = 0; half < VALIDATE_BATCH; half += 16) {
+        __m128i conflict = _mm_setzero_si128();
+        for (int a = 0; a < n; a++) {
+            __m128i row_a = _mm_loadu_si128((const __m128i *)&lanes[a][half]);
+            for (int b = a + 1; b < n; b++) {
+                __m128i row_b = _mm_loadu_si128((const __m128i *)&lanes[b][half]);
+                __m128i distance = _mm_sub_epi8(_mm_max_epu8(row_a, row_b), _mm_min_epu8(row_a, row_b));
+                conflict = _mm_or_si128(conflict, _mm_cmpeq_epi8(distance, _mm_setzero_si128()));
+                conflict = _mm_or_si128(conflict, _mm_cmpeq_epi8(distance, _mm_set1_epi8((char)(b - a))));
+            }
+            if (_mm_movemask_epi8(conflict) == 0xffff) break;
+        }
+        unsigned char result[16];
+        _mm_storeu_si128((__m128i *)result, conflict);
+        for (int k = 0; k < 16 && half + k < count; k++) {
+            valid[half + k] = !result[k];
+        }
+    }
+}
+
+__attribute__((target("avx2")))
+static void validate_candidates_avx2(const unsigned char *candidates, int count, int n, unsigned char *valid) {
+    unsigned char lanes[BITBOARD_MAX_SIZE][VALIDATE_BATCH];
+    transpose_candidates(candidates, count, n, lanes);
+
+    __m256i conflict = _mm256_setzero_si256();
+    for (int a = 0; a < n; a++) {
+        __m256i row_a = _mm256_loadu_si256((const __m256i *)lanes[a]);
+        for (int b = a + 1; b < n; b++) {
+            __m256i row_b = _mm256_loadu_si256((const __m256i *)lanes[b]);
+            __m256i distance = _mm256_sub_epi8(_mm256_max_epu8(row_a, row_b), _mm256_min_epu8(row_a, row_b));
+            conflict = _mm256_or_si256(conflict, _mm256_cmpeq_epi8(distance, _mm256_setzero_si256()));
+            conflict = _mm256_or_si256(conflict, _mm256_cmpeq_epi8(distance, _mm256_set1_epi8((char)(b - a))));
+        }
+        if (_mm256_movemask_epi8(conflict) == -1) break;
+    }
+    unsigned char result[VALIDATE_BATCH];
+    _mm256_storeu_si256((__m256i *)result, conflict);
+    for (int k = 0; k < count; k++) {
+        valid[k] = !result[k];
+    }
+}
+#endif
+
+static ValidateKernel select_validate_kernel(void) {
+#ifdef HAVE_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return validate_candidates_avx2;
+    if (__builtin_cpu_supports("sse2")) return validate_candidates_sse2;
+#endif
+    return validate_candidates_scalar;
+}
+
+/* Chosen once per process; runs on the worker pool and library callers' threads alike. */
+static ValidateKernel validate_kernel;
+static pthread_once_t validate_kernel_once = PTHREAD_ONCE_INIT;
+
+static void choose_validate_kernel(void) {
+    validate_kernel = select_validate_kernel();
+}
+
+/* Fills valid[k] with 1 when candidate k (n row-per-column bytes, count <= VALIDATE_BATCH)
+ * has no two queens on a row or diagonal, using the widest kernel the CPU supports. */
+void validate_candidates(const unsigned char *candidates, int count, int n, unsigned char *valid) {
+    pthread_once(&validate_kernel_once, choose_validate_kernel);
+    validate_kernel(candidates, count, n, valid);
+}
+
+typedef struct {
+    int n;
+    unsigned char placement[BITBOARD_MAX_SIZE];
+    unsigned char batch[VALIDATE_BATCH * BITBOARD_MAX_SIZE];
+    int batch_count;
+    SolverOutput *out;
+} LeafBatch;
+
+/* Validates the queued leaves in order and keeps the first valid one. Leaves queued
+ * after it are taken back out of the operation count, so the count matches a search
+ * that stops at that leaf. */
+static bool flush_leaf_batch(LeafBatch *leaves) {
+    unsigned char valid[VALIDATE_BATCH];
+    int n = leaves->n;
+    validate_candidates(leaves->batch, leaves->batch_count, n, valid);
+
+    for (int k = 0; k < leaves->batch_count; k++) {
+        if (valid[k]) {
+            leaves->out->operation_count -= leaves->batch_count - 1 - k;
+            leaves->out->stats.leaves += k + 1;
+            leaves->out->stats.pruned += k;
+            leaves->out->solution_count = 1;
+            solver_output_emit(leaves->out, leaves->batch + k * n);
+            leaves->batch_count = 0;
+            return true;
+        }
+    }
+    leaves->out->stats.leaves += leaves->batch_count;
+    leaves->out->stats.pruned += leaves->batch_count;
+    leaves->batch_count = 0;
+    return false;
+}
+
+static bool arborescent_search(LeafBatch *leaves, int col) {
+    int n = leaves->n;
+    SolverOutput *out = leaves->out;
+    if (col == n) {
+        solver_output_count_operation(out);
+        memcpy(leaves->batch + leaves->batch_count * n, leaves->placement, n);
+        if (++leaves->batch_count == VALIDATE_BATCH) return flush_leaf_batch(leaves);
+        return false;
+    }
+
+    for (int row = 0; row < n && !out->stopped; row++) {
+        solver_output_branch(out, col, row, n);
+        out->stats.nodes[col]++;
+        leaves->placement[col] = row;
+        if (arborescent_search(leaves, col + 1)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Walks all n^n column placements in order and stops at the first valid one. */
+bool solve_n_queens_arborescent(int n, SolverOutput *out) {
+    if (n < 1 || n > BITBOARD_MAX_SIZE) return false;
+
+    LeafBatch leaves;
+    leaves.n = n;
+    leaves.batch_count = 0;
+    leaves.out = out;
+    out->trace_placement = leaves.placement; /* operations are counted at full boards */
+    out->trace_depth = n;
+
+    bool found = arborescent_search(&leaves, 0)
+                 || (!out->stopped && leaves.batch_count > 0 && flush_leaf_batch(&leaves));
+    out->trace_placement = NULL;
+    return found;
+}
+
+static void bitboard_search(BitboardSearch *search, int col, uint32_t rows, uint32_t ld, uint32_t rd) {
+    int n = search->n;
+    if (col == n) {
+        search->out->stats.leaves++;
+        search->out->solution_count++;
+        solver_output_emit(search->out, search->placement);
+        return;
+    }
+
+    uint32_t available = search->all & ~(rows | ld | rd);
+    if (!available) search->out->stats.pruned++;
+    int branch = 0;
+    int branch_count = (col < PROGRESS_DEPTH) ? __builtin_popcount(available) : 0;
+    while (available && !search->out->stopped) {
+        uint32_t bit = available & -available;
+        available ^= bit;
+        if (col < PROGRESS_DEPTH) solver_output_branch(search->out, col, branch++, branch_count);
+        solver_output_count_node(search->out, col);
+        search->placement[col] = (unsigned char)__builtin_ctz(bit);
+        bitboard_search(search, col + 1, rows | bit, (ld | bit) << 1, (rd | bit) >> 1);
+    }
+}
+
+void solve_n_queens_bitboard(int n, SolverOutput *out) {
+    if (n < 1 || n > BITBOARD_MAX_SIZE) return;
+
+    BitboardSearch search;
+    search.n = n;
+    search.all = (n == 32) ? UINT32_MAX : ((1u << n) - 1);
+    search.out = out;
+    out->trace_placement = search.placement;
+
+    bitboard_search(&search, 0, 0, 0, 0);
+    out->trace_placement = NULL;
+}
+
+/* Resumable depth-first search over the bitboard tree with an explicit stack, yielding
+ * solutions one at a time in lexicographic order. next() runs for at most budget nodes
+ * and can be called again to continue exactly where it paused; memory is O(n). */
+void solution_iterator_init(SolutionIterator *it, int n) {
+    it->n = n;
+    it->all = n >= 32 ? UINT32_MAX : (1u << n) - 1;
+    it->depth = 0;
+    it->rows[0] = it->ld[0] = it->rd[0] = 0;
+    it->available[0] = it->all;
+    it->operations = 0;
+    it->solutions = 0;
+}
+
+IteratorStatus solution_iterator_next(SolutionIterator *it, unsigned char *placement, long long budget) {
+    while (budget-- > 0) {
+        int depth = it->depth;
+        if (depth < 0) return ITERATOR_EXHAUSTED;
+
+        uint32_t available = it->available[depth];
+        if (!available) {
+            it->depth--;
+            continue;
+        }
+
+        uint32_t bit = available & -available;
+        it->available[depth] = available ^ bit;
+        it->placement[depth] = __builtin_ctz(bit);
+        it->operations++;
+
+        if (depth + 1 == it->n) {
+            it->solutions++;
+            memcpy(placement, it->placement, it->n);
+            return ITERATOR_FOUND;
+        }
+
+        uint32_t rows = it->rows[depth] | bit;
+        uint32_t ld = (it->ld[depth] | bit) << 1;
+        uint32_t rd = (it->rd[depth] | bit) >> 1;
+        it->depth = depth + 1;
+        it->rows[depth + 1] = rows;
+        it->ld[depth + 1] = ld;
+        it->rd[depth + 1] = rd;
+        it->available[depth + 1] = it->all & ~(rows | ld | rd);
+    }
+    return ITERATOR_PAUSED;
+}
+
+void board_constraints_reset(BoardConstraints *constraints, int n) {
+    constraints->n = n;
+    for (int col = 0; col < BITBOARD_MAX_SIZE; col++) {
+        constraints->pinned[col] = -1;
+        constraints->blocked[col] = 0;
+    }
+}
+
+/* Places a queen at (row, col) by removing its row and diagonals from every open
+ * column's mask. Returns false as soon as an open column has no square left. */
+static bool completion_place(uint32_t *available, uint32_t open, int col, int row) {
+    uint32_t bit = 1u << row;
+    for (uint32_t rest = open; rest; rest &= rest - 1) {
+        int other = __builtin_ctz(rest);
+        int distance = other > col ? other - col : col - other;
+        uint32_t attacked = bit | (uint32_t)((uint64_t)bit << distance) | (bit >> distance);
+        available[other] &= ~attacked;
+        if (!available[other]) return false;
+    }
+    return true;
+}
+
+/* Forward-checking search over per-column masks: the open column with the fewest
+ * squares left is filled next, so a contradiction surfaces within a level or two
+ * instead of deep in a lexicographic walk. */
+static bool completion_search(const uint32_t *available, uint32_t open, unsigned char *placement, CountState *state) {
+    if (!open) return true;
+
+    int col = -1;
+    int fewest = INT_MAX;
+    for (uint32_t rest = open; rest; rest &= rest - 1) {
+        int candidate = __builtin_ctz(rest);
+        int count = __builtin_popcount(available[candidate]);
+        if (count < fewest) {
+            fewest = count;
+            col = candidate;
+        }
+    }
+
+    uint32_t remaining = open & ~(1u << col);
+    for (uint32_t rows = available[col]; rows && !state->stopped; rows &= rows - 1) {
+        int row = __builtin_ctz(rows);
+        if ((++state->operations & CANCEL_CHECK_MASK) == 0 && state->cancel) {
+            state->stopped = atomic_load_explicit(state->cancel, memory_order_relaxed);
+        }
+
+        uint32_t next[BITBOARD_MAX_SIZE];
+        memcpy(next, available, sizeof(next));
+        if (!completion_place(next, remaining, col, row)) {
+            if (state->stats) state->stats->pruned++;
+            continue;
+        }
+        placement[col] = (unsigned char)row;
+        if (completion_search(next, remaining, placement, state)) return true;
+    }
+    return false;
+}
+
+/* Finds one full placement honouring the pinned queens and blocked squares. Returns
+ * false when none exists or state->cancel was raised (state->stopped tells which). */
+bool complete_board(const BoardConstraints *constraints, unsigned char *placement, CountState *state) {
+    int n = constraints->n;
+    if (n < 1 || n > BITBOARD_MAX_SIZE) return false;
+
+    uint32_t all = n == 32 ? UINT32_MAX : (1u << n) - 1;
+    uint32_t available[BITBOARD_MAX_SIZE] = {0};
+    uint32_t open = all;
+    for (int col = 0; col < n; col++) available[col] = all & ~constraints->blocked[col];
+
+    for (int col = 0; col < n; col++) {
+        int row = constraints->pinned[col];
+        if (row < 0) continue;
+        if (!(available[col] & (1u << row))) return false;
+        open &= ~(1u << col);
+        placement[col] = (unsigned char)row;
+        if (!completion_place(available, open, col, row)) return false;
+    }
+    return completion_search(available, open, placement, state);
+}
+
+/* Image of a row-per-column placement under one of the 8 symmetries of the square. */
+void transform_placement(const unsigned char *src, unsigned char *dst, int n, int symmetry) {
+    for (int c = 0; c < n; c++) {
+        int r = src[c];
+        switch (symmetry) {
+            case 0: dst[c] = r; break;
+            case 1: dst[n - 1 - r] = c; break;
+            case 2: dst[n - 1 - c] = n - 1 - r; break;
+            case 3: dst[r] = n - 1 - c; break;
+            case 4: dst[c] = n - 1 - r; break;
+            case 5: dst[n - 1 - c] = r; break;
+            case 6: dst[r] = c; break;
+            case 7: dst[n - 1 - r] = n - 1 - c; break;
+        }
+    }
+}
+
+/* Returns the size of the symmetry class (1, 2, 4 or 8) if the placement is its
+ * lexicographically smallest member, 0 otherwise. */
+static int symmetry_class_size(const unsigned char *placement, int n) {
+    unsigned char image[BITBOARD_MAX_SIZE];
+    int stabilizer = 1;
+
+    for (int symmetry = 1; symmetry < 8; symmetry++) {
+        transform_placement(placement, image, n, symmetry);
+        int cmp = memcmp(image, placement, n);
+        if (cmp < 0) return 0;
+        if (cmp == 0) stabilizer++;
+    }
+    return 8 / stabilizer;
+}
+
+/* True if image `symmetry` of the placement does not repeat an earlier image. */
+bool is_distinct_image(const unsigned char *placement, int n, int symmetry) {
+    unsigned char image[BITBOARD_MAX_SIZE];
+    unsigned char earlier[BITBOARD_MAX_SIZE];
+
+    transform_placement(placement, image, n, symmetry);
+    for (int k = 0; k < symmetry; k++) {
+        transform_placement(placement, earlier, n, k);
+        if (memcmp(image, earlier, n) == 0) return false;
+    }
+    return true;
+}
+
+static uint32_t row_range_mask(int lo, int hi) {
+    return (uint32_t)(((1ull << (hi + 1)) - 1) & ~((1ull << lo) - 1));
+}
+
+/* Only canonical placements are completed. A canonical placement is not larger than
+ * any of its images, whose first entries come from the first and last columns and
+ * the first and last rows; with lo = placement[0] all of these must lie in [lo, n-1-lo]. */
+static void symmetry_search(BitboardSearch *search, int col, uint32_t rows, uint32_t ld, uint32_t rd) {
+    int n = search->n;
+    if (col == n) {
+        search->out->stats.leaves++;
+        int class_size = symmetry_class_size(search->placement, n);
+        if (class_size == 0) {
+            search->out->stats.pruned++;
+            return;
+        }
+
+        search->out->solution_count += class_size;
+        solver_output_emit(search->out, search->placement);
+        return;
+    }
+
+    uint32_t available = search->all & ~(rows | ld | rd);
+    if (col == 0) {
+        available &= row_range_mask(0, (n - 1) / 2);
+    } else {
+        int lo = search->placement[0];
+        int hi = n - 1 - lo;
+        if (col < lo || col > hi) available &= ~(1u | (1u << (n - 1)));
+        if (col == n - 1) available &= row_range_mask(lo, hi);
+    }
+    if (!available) search->out->stats.pruned++;
+
+    int branch = 0;
+    int branch_count = (col < PROGRESS_DEPTH) ? __builtin_popcount(available) : 0;
+    while (available && !search->out->stopped) {
+        uint32_t bit = available & -available;
+        available ^= bit;
+        if (col < PROGRESS_DEPTH) solver_output_branch(search->out, col, branch++, branch_count);
+        solver_output_count_node(search->out, col);
+        search->placement[col] = (unsigned char)__builtin_ctz(bit);
+        symmetry_search(search, col + 1, rows | bit, (ld | bit) << 1, (rd | bit) >> 1);
+    }
+}
+
+void solve_n_queens_symmetric(int n, SolverOutput *out) {
+    if (n < 1 || n > BITBOARD_MAX_SIZE) return;
+
+    BitboardSearch search;
+    search.n = n;
+    search.all = (n == 32) ? UINT32_MAX : ((1u << n) - 1);
+    search.out = out;
+    out->trace_placement = search.placement;
+
+    symmetry_search(&search, 0, 0, 0, 0);
+    out->trace_placement = NULL;
+}
+
+static long long bitboard_count_column(uint32_t all, int col, uint32_t rows, uint32_t ld, uint32_t rd,
+                                       CountState *state) {
+    SolverStats *stats = state->stats;
+    if (rows == all) {
+        if (stats) {
+            stats->leaves++;
+            stats->solutions++;
+        }
+        return 1;
+    }
+
+    long long solutions = 0;
+    uint32_t available = all & ~(rows | ld | rd);
+    if (!available && stats) stats->pruned++;
+    while (available && !state->stopped) {
+        uint32_t bit = available & -available;
+        available ^= bit;
+        if ((++state->operations & CANCEL_CHECK_MASK) == 0 && state->cancel) {
+            state->stopped = atomic_load_explicit(state->cancel, memory_order_relaxed);
+        }
+        if (stats) stats->nodes[col]++;
+        solutions += bitboard_count_column(all, col + 1, rows | bit, (ld | bit) << 1, (rd | bit) >> 1, state);
+    }
+    return solutions;
+}
+
+long long bitboard_count(uint32_t all, uint32_t rows, uint32_t ld, uint32_t rd, CountState *state) {
+    return bitboard_count_column(all, __builtin_popcount(rows), rows, ld, rd, state);
+}
+
+/* Counting kernels specialised per board size: with n a compile-time constant the
+ * masks are immediates and the stack has a fixed size. The search is iterative with
+ * the current node in registers; the last two columns are resolved inline without
+ * pushing, and cancellation is polled on backtracks near the root only. Operation
+ * counts and statistics match bitboard_count exactly; nodes are tallied per column on
+ * the stack and handed to state->stats once at the end. */
+#define DEFINE_COUNT_KERNEL(N) \
+static long long count_kernel_##N(uint32_t all_unused, uint32_t rows, uint32_t ld, uint32_t rd, CountState *state) { \
+    (void)all_unused; /* kept so the kernels share bitboard_count's signature */ \
+    const uint32_t all = (uint32_t)((1ull << (N)) - 1); \
+    uint32_t stack_available[N], stack_rows[N], stack_ld[N], stack_rd[N]; \
+    int base = __builtin_popcount(rows); \
+    if (base >= (N)) { \
+        if (state->stats) { \
+            state->stats->leaves++; \
+            state->stats->solutions++; \
+        } \
+        return 1; \
+    } \
+    ld &= all; \
+    uint32_t available = all & ~(rows | ld | rd); \
+    long long solutions = 0; \
+    long long nodes[N] = {0}; \
+    long long pruned = 0; \
+    int col = base; \
+    for (;;) { \
+        while (available) { \
+            uint32_t bit = available & -available; \
+            available ^= bit; \
+            nodes[col]++; \
+            uint32_t next_rows = rows | bit; \
+            uint32_t next_ld = ((ld | bit) << 1) & all; \
+            uint32_t next_rd = (rd | bit) >> 1; \
+            uint32_t next_available = all & ~(next_rows | next_ld | next_rd); \
+            if (col >= (N) - 2) { \
+                if (col == (N) - 1) { \
+                    solutions++; \
+                    continue; \
+                } \
+                long long leaves = 0; \
+                for (; next_available; next_available &= next_available - 1) leaves++; \
+                nodes[col + 1] += leaves; \
+                solutions += leaves; \
+                pruned += leaves == 0; \
+                continue; \
+            } \
+            if (!next_available) { \
+                pruned++; \
+                continue; \
+            } \
+            stack_available[col] = available; \
+            stack_rows[col] = rows; \
+            stack_ld[col] = ld; \
+            stack_rd[col] = rd; \
+            col++; \
+            rows = next_rows; \
+            ld = next_ld; \
+            rd = next_rd; \
+            available = next_available; \
+        } \
+        if (col == base) break; \
+        col--; \
+        available = stack_available[col]; \
+        rows = stack_rows[col]; \
+        ld = stack_ld[col]; \
+        rd = stack_rd[col]; \
+        if (col < (N) - 6 && state->cancel && atomic_load_explicit(state->cancel, memory_order_relaxed)) { \
+            state->stopped = true; \
+            break; \
+        } \
+    } \
+    SolverStats *stats = state->stats; \
+    for (int c = base; c < (N); c++) { \
+        state->operations += nodes[c]; \
+        if (stats) stats->nodes[c] += nodes[c]; \
+    } \
+    if (stats) { \
+        stats->pruned += pruned; \
+        stats->leaves += solutions; \
+        stats->solutions += solutions; \
+    } \
+    return solutions; \
+}
+
+#define FOR_EACH_KERNEL_SIZE(X) \
+    X(4) X(5) X(6) X(7) X(8) X(9) X(10) X(11) X(12) X(13) X(14) X(15) X(16) X(17) \
+    X(18) X(19) X(20) X(21) X(22) X(23) X(24) X(25) X(26) X(27) X(28) X(29) X(30) \
+    X(31) X(32)
+
+FOR_EACH_KERNEL_SIZE(DEFINE_COUNT_KERNEL)
+
+#define COUNT_KERNEL_ENTRY(N) [N] = count_kernel_##N,
+static const CountKernel count_kernels[BITBOARD_MAX_SIZE + 1] = {
+    FOR_EACH_KERNEL_SIZE(COUNT_KERNEL_ENTRY)
+};
+
+/* Cleared by --generic-kernels so the benchmark can compare against bitboard_count. */
+bool use_specialized_kernels = true;
+
+CountKernel select_count_kernel(int n) {
+    if (use_specialized_kernels && n >= 1 && n <= BITBOARD_MAX_SIZE && count_kernels[n]) return count_kernels[n];
+    return bitboard_count;
+}
+
+int hardware_thread_count(void) {
+#ifdef _WIN32
+    return pthread_num_processors_np();
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int)count : 1;
+#endif
+}
+
+void collect_prefix_tasks(uint32_t all, int depth, uint32_t rows, uint32_t ld, uint32_t rd,
+                          PrefixTask *tasks, int *task_count, long long *operation_count,
+                          SolverStats *stats) {
+    if (depth == 0 || rows == all) {
+        tasks[*task_count].rows = rows;
+        tasks[*task_count].ld = ld;
+        tasks[*task_count].rd = rd;
+        (*task_count)++;
+        return;
+    }
+
+    uint32_t available = all & ~(rows | ld | rd);
+    if (!available && stats) stats->pruned++;
+    while (available) {
+        uint32_t bit = available & -available;
+        available ^= bit;
+        (*operation_count)++;
+        if (stats) stats->nodes[__builtin_popcount(rows)]++;
+        collect_prefix_tasks(all, depth - 1, rows | bit, (ld | bit) << 1, (rd | bit) >> 1, tasks, task_count,
+                             operation_count, stats);
+    }
+}
+
+/* The owner pops from the tail, thieves take from the head of another worker's deque. */
+static bool take_task(ParallelCounter *counter, int self, PrefixTask *task) {
+    for (int k = 0; k < counter->worker_count; k++) {
+        TaskDeque *deque = &counter->deques[(self + k) % counter->worker_count];
+        bool found = false;
+
+        pthread_mutex_lock(&deque->lock);
+        if (deque->head < deque->tail) {
+            *task = (k == 0) ? deque->tasks[--deque->tail] : deque->tasks[deque->head++];
+            found = true;
+        }
+        pthread_mutex_unlock(&deque->lock);
+
+        if (found) return true;
+    }
+    return false;
+}
+
+/* Each worker counts into private statistics and copies them out under its own lock
+ * after every task, so the coordinator never merges a half-updated snapshot. */
+static void* counter_worker_func(void *arg) {
+    CounterWorker *worker = (CounterWorker *)arg;
+    ParallelCounter *counter = worker->counter;
+    SolverStats stats = {0};
+    CountState state = {0, counter->cancel, false, &stats};
+    long long solutions = 0;
+    PrefixTask task;
+
+    while (!state.stopped && take_task(counter, worker->index, &task)) {
+        solutions += counter->kernel(counter->all, task.rows, task.ld, task.rd, &state);
+        atomic_store_explicit(&worker->solutions, solutions, memory_order_relaxed);
+        atomic_store_explicit(&worker->operations, state.operations, memory_order_relaxed);
+        pthread_mutex_lock(&worker->stats_lock);
+        worker->stats = stats;
+        pthread_mutex_unlock(&worker->stats_lock);
+        atomic_fetch_add_explicit(&counter->tasks_done, 1, memory_order_release);
+    }
+    return NULL;
+}
+
+/* The prefix statistics plus every worker's latest snapshot. */
+static void merge_counter_stats(ParallelCounter *counter, const SolverStats *prefix, SolverOutput *out) {
+    SolverStats merged = *prefix;
+    for (int i = 0; i < counter->worker_count; i++) {
+        CounterWorker *worker = &counter->workers[i];
+        pthread_mutex_lock(&worker->stats_lock);
+        solver_stats_merge(&merged, &worker->stats);
+        pthread_mutex_unlock(&worker->stats_lock);
+    }
+    memcpy(out->stats.nodes, merged.nodes, sizeof(merged.nodes));
+    out->stats.pruned = merged.pruned;
+    out->stats.leaves = merged.leaves;
+}
+
+/* Counts all solutions on thread_count workers (0 = one per hardware thread). While the
+ * workers run, the calling thread publishes running totals and progress through out. */
+long long count_n_queens_parallel(int n, int thread_count, SolverOutput *out) {
+    if (n < 1 || n > BITBOARD_MAX_SIZE) return 0;
+    if (thread_count < 1) thread_count = hardware_thread_count();
+
+    uint32_t all = (n == 32) ? UINT32_MAX : ((1u << n) - 1);
+
+    /* Go one level deeper until there are enough prefixes to keep every worker busy. */
+    int depth = 1;
+    long long estimate = n;
+    while (depth < n / 2 && estimate < (long long)PARALLEL_TASKS_PER_THREAD * thread_count) {
+        estimate *= n;
+        depth++;
+    }
+
+    uint64_t setup_start = monotonic_ns();
+    PrefixTask *tasks = malloc(estimate * sizeof(PrefixTask));
+    int task_count = 0;
+    long long prefix_operations = 0;
+    SolverStats prefix_stats = {0};
+    collect_prefix_tasks(all, depth, 0, 0, 0, tasks, &task_count, &prefix_operations, &prefix_stats);
+
+    ParallelCounter counter;
+    counter.all = all;
+    counter.kernel = select_count_kernel(n);
+    counter.cancel = out->cancel;
+    atomic_init(&counter.tasks_done, 0);
+    counter.worker_count = thread_count;
+    counter.deques = calloc(thread_count, sizeof(TaskDeque));
+    counter.workers = calloc(thread_count, sizeof(CounterWorker));
+
+    for (int i = 0; i < thread_count; i++) {
+        TaskDeque *deque = &counter.deques[i];
+        deque->tasks = malloc((task_count / thread_count + 1) * sizeof(PrefixTask));
+        pthread_mutex_init(&deque->lock, NULL);
+    }
+    for (int i = 0; i < task_count; i++) {
+        TaskDeque *deque = &counter.deques[i % thread_count];
+        deque->tasks[deque->tail++] = tasks[i];
+    }
+
+    for (int i = 0; i < thread_count; i++) {
+        counter.workers[i].counter = &counter;
+        counter.workers[i].index = i;
+        atomic_init(&counter.workers[i].solutions, 0);
+        atomic_init(&counter.workers[i].operations, 0);
+        pthread_mutex_init(&counter.workers[i].stats_lock, NULL);
+    }
+    /* Deques of workers that could not be started are stolen by the others; with no
+     * worker at all the calling thread counts everything itself. */
+    int started = 0;
+    while (started < thread_count
+           && pthread_create(&counter.workers[started].thread, NULL, counter_worker_func,
+                             &counter.workers[started]) == 0) {
+        started++;
+    }
+    out->stats.phase_ns[SOLVER_PHASE_SETUP] += monotonic_ns() - setup_start;
+    if (started == 0) counter_worker_func(&counter.workers[0]);
+
+    long pause_ns = 100000;
+    for (;;) {
+        int done = atomic_load_explicit(&counter.tasks_done, memory_order_acquire);
+        if (done == task_count || out->stopped) break;
+
+        struct timespec pause = {0, pause_ns};
+        nanosleep(&pause, NULL);
+        if (pause_ns < PARALLEL_POLL_INTERVAL_NS) pause_ns *= 2;
+
+        out->solution_count = 0;
+        out->operation_count = prefix_operations;
+        for (int i = 0; i < thread_count; i++) {
+            out->solution_count += atomic_load_explicit(&counter.workers[i].solutions, memory_order_relaxed);
+            out->operation_count += atomic_load_explicit(&counter.workers[i].operations, memory_order_relaxed);
+        }
+        merge_counter_stats(&counter, &prefix_stats, out);
+        solver_output_branch(out, 0, done, task_count);
+        solver_output_poll(out);
+    }
+
+    long long solutions = 0;
+    long long operations = prefix_operations;
+    for (int i = 0; i < thread_count; i++) {
+        if (i < started) pthread_join(counter.workers[i].thread, NULL);
+        solutions += atomic_load(&counter.workers[i].solutions);
+        operations += atomic_load(&counter.workers[i].operations);
+    }
+    merge_counter_stats(&counter, &prefix_stats, out);
+
+    for (int i = 0; i < thread_count; i++) {
+        pthread_mutex_destroy(&counter.workers[i].stats_lock);
+        pthread_mutex_destroy(&counter.deques[i].lock);
+        free(counter.deques[i].tasks);
+    }
+    free(counter.deques);
+    free(counter.workers);
+    free(tasks);
+
+    out->solution_count = solutions;
+    out->operation_count = operations;
+    return solutions;
+}
+
+/* Lockstep counting: LANES prefix subtrees are searched at once, one per vector lane.
+ * Each step every lane either places its next queen or backtracks, so lanes drift to
+ * different depths, and a lane whose subtree is exhausted is refilled from the task
+ * list. There is no per-lane stack to gather from: ld is kept unmasked and rd shifted
+ * up by n bits so both shifts can be undone exactly, and the rows placed are kept
+ * POS_BITS apiece in PATH_WORDS shift-register words. Narrow lanes (32 bits) cover
+ * n <= 16, wide lanes (64 bits) the rest. Counts, operations, pruned and leaves match
+ * bitboard_count; nodes are only split per column inside the prefix. */
+typedef struct {
+    uint32_t all;
+    int n;
+    int base; /* column the prefix tasks start at */
+    const PrefixTask *tasks;
+    int task_count;
+    int next_task;
+    int tasks_done;
+    long long prefix_operations;
+    long long solutions;
+    long long operations;
+    long long pruned;
+    SolverOutput *out;
+} LockstepSearch;
+
+typedef void (*LockstepKernel)(LockstepSearch *search);
+
+typedef struct {
+    LockstepKernel run;
+    int lanes;
+} LockstepVariant;
+
+/* Folds the lane counters into the totals and publishes them; false once cancelled. */
+static bool lockstep_report(LockstepSearch *search, long long solutions, long long operations, long long pruned) {
+    SolverOutput *out = search->out;
+    search->solutions += solutions;
+    search->operations += operations;
+    search->pruned += pruned;
+    out->solution_count = search->solutions;
+    out->operation_count = search->prefix_operations + search->operations;
+    solver_output_branch(out, 0, search->tasks_done, search->task_count);
+    solver_output_poll(out);
+    return !out->stopped;
+}
+
+#define LOCKSTEP_SUM_LANES(V, LANES, SUM) \
+    do { \
+        SUM = 0; \
+        for (int lane_ = 0; lane_ < (LANES); lane_++) SUM += (long long)(V)[lane_]; \
+    } while (0)
+
+#define DEFINE_LOCKSTEP_KERNEL(NAME, TARGET, ELEM, LANES, POS_BITS, PATH_WORDS) \
+TARGET static void NAME(LockstepSearch *search) { \
+    typedef ELEM vec __attribute__((vector_size(sizeof(ELEM) * (LANES)))); \
+    typedef int32_t ivec __attribute__((vector_size(4 * (LANES)))); \
+    typedef float fvec __attribute__((vector_size(4 * (LANES)))); \
+    enum { BITS = 8 * sizeof(ELEM), LEVELS = BITS / (POS_BITS) }; \
+    const int n = search->n; \
+    const int base = search->base; \
+    const ELEM all = search->all; \
+    const ELEM pos_mask = ((ELEM)1 << (POS_BITS)) - 1; \
+    const ELEM word_mask = (ELEM)-1 >> (BITS - LEVELS * (POS_BITS)); \
+    const vec zero = {0}; \
+    const vec one = zero + 1; \
+    vec rows = zero, ld = zero, rd = zero, avail = zero, col = zero, active = zero; \
+    vec path[PATH_WORDS]; \
+    vec nodes = zero, solutions = zero, pruned = zero; \
+    for (int w = 0; w < (PATH_WORDS); w++) path[w] = zero; \
+    int busy = 0; \
+    for (int lane = 0; lane < (LANES); lane++) rows[lane] = all; \
+    for (int blocks = 0;; blocks++) { \
+        /* Refill lanes sitting exhausted at their task root. */ \
+        for (int lane = 0; lane < (LANES); lane++) { \
+            if (avail[lane] || (col[lane] != (ELEM)base && active[lane])) continue; \
+            if (active[lane]) { \
+                search->tasks_done++; \
+                busy--; \
+                active[lane] = 0; \
+            } \
+            if (search->next_task == search->task_count) continue; \
+            const PrefixTask *task = &search->tasks[search->next_task++]; \
+            rows[lane] = task->rows; \
+            ld[lane] = task->ld & all; \
+            rd[lane] = (ELEM)task->rd << n; \
+            avail[lane] = all & ~(task->rows | task->ld | task->rd); \
+            if (!avail[lane]) search->pruned++; \
+            col[lane] = base; \
+            for (int w = 0; w < (PATH_WORDS); w++) path[w][lane] = 0; \
+            active[lane] = (ELEM)-1; \
+            busy++; \
+        } \
+        if (busy == 0 || blocks == LOCKSTEP_POLL_BLOCKS) { \
+            long long lane_solutions, lane_nodes, lane_pruned; \
+            LOCKSTEP_SUM_LANES(solutions, LANES, lane_solutions); \
+            LOCKSTEP_SUM_LANES(nodes, LANES, lane_nodes); \
+            LOCKSTEP_SUM_LANES(pruned, LANES, lane_pruned); \
+            nodes = solutions = pruned = zero; \
+            blocks = 0; \
+            if (!lockstep_report(search, lane_solutions, lane_nodes, lane_pruned) || busy == 0) return; \
+        } \
+        for (int step = 0; step < LOCKSTEP_BLOCK_STEPS; step++) { \
+            vec has = (vec)(avail != 0); \
+            vec bit = avail & -avail; \
+            vec next_rows = rows | bit; \
+            vec next_ld = (ld | bit) << 1; \
+            vec next_rd = (rd | (bit << n)) >> 1; \
+            vec next_avail = all & ~(next_rows | next_ld | (next_rd >> n)); \
+            vec alive = (vec)(next_avail != 0); \
+            vec last = (vec)(col == (ELEM)(n - 2)); \
+            vec push = has & alive & ~last; \
+            vec pop = ~has & (vec)(col > (ELEM)base); \
+            vec keep = ~(push | pop); \
+            nodes -= has + (has & alive & last); \
+            solutions -= has & alive & last; \
+            pruned -= has & ~alive; \
+            \
+            /* Row of the new queen from the exponent of its bit as a float. */ \
+            ivec exponent = ((ivec)__builtin_convertvector(__builtin_convertvector(bit, ivec), fvec) >> 23) & 0xff; \
+            vec pos_in = __builtin_convertvector(exponent - 127, vec); \
+            vec back = one << (path[0] & pos_mask); \
+            vec prev_rows = rows ^ back; \
+            vec prev_ld = (ld >> 1) ^ back; \
+            vec prev_rd = (rd << 1) ^ (back << n); \
+            vec prev_avail = all & ~(prev_rows | prev_ld | (prev_rd >> n)) & -(back << 1); \
+            \
+            vec next_path[PATH_WORDS]; \
+            for (int w = 0; w < (PATH_WORDS); w++) { \
+                vec lower = w ? path[w - 1] >> ((LEVELS - 1) * (POS_BITS)) : pos_in; \
+                vec upper = w + 1 < (PATH_WORDS) ? (path[w + 1] & pos_mask) << ((LEVELS - 1) * (POS_BITS)) : zero; \
+                vec pushed = ((path[w] << (POS_BITS)) | lower) & word_mask; \
+                vec popped = (path[w] >> (POS_BITS)) | upper; \
+                next_path[w] = (pushed & push) | (popped & pop) | (path[w] & keep); \
+            } \
+            for (int w = 0; w < (PATH_WORDS); w++) path[w] = next_path[w]; \
+            \
+            rows = (next_rows & push) | (prev_rows & pop) | (rows & keep); \
+            ld = (next_ld & push) | (prev_ld & pop) | (ld & keep); \
+            rd = (next_rd & push) | (prev_rd & pop) | (rd & keep); \
+            avail = (next_avail & push) | (prev_avail & pop) | ((avail ^ bit) & keep); \
+            col = col - push + pop; \
+        } \
+    } \
+}
+
+DEFINE_LOCKSTEP_KERNEL(lockstep_portable_narrow, , uint32_t, 4, 4, 2)
+DEFINE_LOCKSTEP_KERNEL(lockstep_portable_wide, , uint64_t, 2, 5, 3)
+#ifdef HAVE_X86_SIMD
+DEFINE_LOCKSTEP_KERNEL(lockstep_avx2_narrow, __attribute__((target("avx2"))), uint32_t, 8, 4, 2)
+DEFINE_LOCKSTEP_KERNEL(lockstep_avx2_wide, __attribute__((target("avx2"))), uint64_t, 4, 5, 3)
+DEFINE_LOCKSTEP_KERNEL(lockstep_avx512_narrow, __attribute__((target("avx512f"))), uint32_t, 16, 4, 2)
+DEFINE_LOCKSTEP_KERNEL(lockstep_avx512_wide, __attribute__((target("avx512f"))), uint64_t, 8, 5, 3)
+#endif
+
+/* The widest kernel the CPU supports; --generic-kernels forces the portable one, which
+ * the compiler lowers to whatever vector unit (or scalar code) the target has. */
+static LockstepVariant select_lockstep_variant(int n) {
+    bool narrow = n <= 16;
+#ifdef HAVE_X86_SIMD
+    if (use_specialized_kernels) {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) {
+            return narrow ? (LockstepVariant){lockstep_avx512_narrow, 16} : (LockstepVariant){lockstep_avx512_wide, 8};
+        }
+        if (__builtin_cpu_supports("avx2")) {
+            return narrow ? (LockstepVariant){lockstep_avx2_narrow, 8} : (LockstepVariant){lockstep_avx2_wide, 4};
+        }
+    }
+#endif
+    return narrow ? (LockstepVariant){lockstep_portable_narrow, 4} : (LockstepVariant){lockstep_portable_wide, 2};
+}
+
+/* Counts all solutions on the calling thread with the lockstep kernel. Boards too small
+ * to give every lane a subtree go to the scalar kernel. */
+long long count_n_queens_lockstep(int n, SolverOutput *out) {
+    if (n < 1 || n > BITBOARD_MAX_SIZE) return 0;
+    uint32_t all = (n == 32) ? UINT32_MAX : ((1u << n) - 1);
+
+    if (n < LOCKSTEP_MIN_SIZE) {
+        CountState state = {0, out->cancel, false, &out->stats};
+        out->solution_count = select_count_kernel(n)(all, 0, 0, 0, &state);
+        out->operation_count = state.operations;
+        return out->solution_count;
+    }
+
+    uint64_t setup_start = monotonic_ns();
+    LockstepVariant variant = select_lockstep_variant(n);
+    int depth = 1;
+    long long estimate = n;
+    while (depth < n - 3 && estimate < (long long)LOCKSTEP_TASKS_PER_LANE * variant.lanes) {
+        estimate *= n;
+        depth++;
+    }
+
+    LockstepSearch search = {0};
+    search.all = all;
+    search.n = n;
+    search.base = depth;
+    search.out = out;
+    PrefixTask *tasks = malloc(estimate * sizeof(PrefixTask));
+    SolverStats prefix_stats = {0};
+    collect_prefix_tasks(all, depth, 0, 0, 0, tasks, &search.task_count, &search.prefix_operations, &prefix_stats);
+    search.tasks = tasks;
+    solver_stats_merge(&out->stats, &prefix_stats);
+    out->stats.phase_ns[SOLVER_PHASE_SETUP] += monotonic_ns() - setup_start;
+
+    variant.run(&search);
+    free(tasks);
+
+    out->stats.pruned += search.pruned;
+    out->stats.leaves += search.solutions;
+    return search.solutions;
+}
+
+/* Random access to the k-th solution in lexicographic order (column 0's row first,
+ * the order bitboard_search emits them). Unranking walks down the tree, skipping whole
+ * sibling subtrees by their solution counts. Those are counted only when the walk
+ * reaches them, and counts of nodes shallower than UNRANK_CACHE_DEPTH are memoised by
+ * board state, so a jump costs the subtrees left of its path and later jumps reuse them. */
+
+void solution_index_reset(SolutionIndex *index, int n) {
+    free(index->entries);
+    index->n = n;
+    index->all = n >= 32 ? UINT32_MAX : (1u << n) - 1;
+    index->capacity = 1024;
+    index->used = 0;
+    index->entries = calloc(index->capacity, sizeof(SubtreeCount));
+}
+
+void solution_index_free(SolutionIndex *index) {
+    free(index->entries);
+    *index = (SolutionIndex){0};
+}
+
+static size_t subtree_slot(const SolutionIndex *index, int depth, uint32_t rows, uint32_t ld, uint32_t rd) {
+    uint64_t hash = ((uint64_t)rows * 0x9e3779b97f4a7c15ull) ^ ((uint64_t)ld << 21) ^ ((uint64_t)rd * 0xc2b2ae3d27d4eb4full) ^ (uint64_t)depth;
+    hash ^= hash >> 29;
+    size_t slot = (size_t)hash & (index->capacity - 1);
+    while (index->entries[slot].depth) {
+        const SubtreeCount *entry = &index->entries[slot];
+        if (entry->depth == depth + 1 && entry->rows == rows && entry->ld == ld && entry->rd == rd) break;
+        slot = (slot + 1) & (index->capacity - 1);
+    }
+    return slot;
+}
+
+static void subtree_insert(SolutionIndex *index, int depth, uint32_t rows, uint32_t ld, uint32_t rd, long long count) {
+    if (2 * (index->used + 1) > index->capacity) {
+        SubtreeCount *old = index->entries;
+        size_t old_capacity = index->capacity;
+        index->capacity *= 2;
+        index->entries = calloc(index->capacity, sizeof(SubtreeCount));
+        for (size_t i = 0; i < old_capacity; i++) {
+            if (!old[i].depth) continue;
+            index->entries[subtree_slot(index, old[i].depth - 1, old[i].rows, old[i].ld, old[i].rd)] = old[i];
+        }
+        free(old);
+    }
+    size_t slot = subtree_slot(index, depth, rows, ld, rd);
+    if (!index->entries[slot].depth) index->used++;
+    index->entries[slot] = (SubtreeCount){rows, ld, rd, depth + 1, count};
+}
+
+/* The number of solutions once walks have counted every column-0 subtree, which an
+ * out-of-range rank always does; -1 before that. Never searches. */
+long long solution_index_known_total(const SolutionIndex *index) {
+    long long total = 0;
+    for (uint32_t available = index->all; available; available &= available - 1) {
+        uint32_t bit = available & -available;
+        const SubtreeCount *entry = &index->entries[subtree_slot(index, 1, bit, (bit << 1) & index->all, bit >> 1)];
+        if (!entry->depth) return -1;
+        total += entry->count;
+    }
+    return total;
+}
+
+/* Looks for solution *rank below the node reached after depth columns. When it is not
+ * there, the node's solution count is taken off *rank and false returned. A node is
+ * only counted whole when the walk passes it, never on the way into it; deep nodes go
+ * to the counting kernel, shallow ones are memoised. */
+static bool unrank_below(SolutionIndex *index, int depth, uint32_t rows, uint32_t ld, uint32_t rd,
+                         long long *rank, unsigned char *placement, CountState *state) {
+    ld &= index->all;
+    bool cached = depth < UNRANK_CACHE_DEPTH;
+    long long count = -1;
+    if (cached) {
+        const SubtreeCount *entry = &index->entries[subtree_slot(index, depth, rows, ld, rd)];
+        if (entry->depth) count = entry->count;
+    } else {
+        count = select_count_kernel(index->n)(index->all, rows, ld, rd, state);
+    }
+    if (count >= 0 && *rank >= count) {
+        *rank -= count;
+        return false;
+    }
+
+    long long before = *rank;
+    if (rows == index->all) {
+        if (*rank == 0) return true;
+        (*rank)--;
+    }
+    uint32_t available = index->all & ~(rows | ld | rd);
+    while (available && !state->stopped) {
+        uint32_t bit = available & -available;
+        available ^= bit;
+        placement[depth] = __builtin_ctz(bit);
+        if (unrank_below(index, depth + 1, rows | bit, (ld | bit) << 1, (rd | bit) >> 1, rank, placement, state)) {
+            return true;
+        }
+    }
+    if (cached && count < 0 && !state->stopped) subtree_insert(index, depth, rows, ld, rd, before - *rank);
+    return false;
+}
+
+/* Writes the rank-th solution (0-based) into placement. Returns false when rank is out
+ * of range, found by running out of column-0 subtrees, or the walk was cancelled. */
+bool solution_index_unrank(SolutionIndex *index, long long rank, unsigned char *placement, CountState *state) {
+    if (rank < 0) return false;
+    return unrank_below(index, 0, 0, 0, 0, &rank, placement, state) && !state->stopped;
+}
+
+/* Dancing Links: n-queens as exact cover. Every row and column is a primary item that
+ * must be covered exactly once; the 2n - 1 diagonals of each direction are secondary
+ * items covered at most once. Each square is an option of four nodes, one per item.
+ * All links live in flat arrays sized up front, header nodes first (0 is the root,
+ * then the rows, columns and diagonals), so the search never allocates. */
+typedef struct {
+    int n;
+    int *left;
+    int *right;
+    int *up;
+    int *down;
+    int *item; /* header of each node */
+    int *size; /* options left per item */
+    int *square; /* row * n + col of each option node */
+    unsigned char placement[BITBOARD_MAX_SIZE];
+    SolverOutput *out;
+} DlxSearch;
+
+static void dlx_init(DlxSearch *dlx, int n, SolverOutput *out) {
+    int items = 2 * n + 2 * (2 * n - 1);
+    int nodes = 1 + items + 4 * n * n;
+    int *pool = malloc((size_t)nodes * 7 * sizeof(int));
+    dlx->n = n;
+    dlx->out = out;
+    dlx->left = pool;
+    dlx->right = pool + nodes;
+    dlx->up = pool + 2 * nodes;
+    dlx->down = pool + 3 * nodes;
+    dlx->item = pool + 4 * nodes;
+    dlx->size = pool + 5 * nodes;
+    dlx->square = pool + 6 * nodes;
+
+    for (int i = 0; i <= items; i++) {
+        dlx->up[i] = dlx->down[i] = dlx->item[i] = i;
+        dlx->size[i] = 0;
+        bool primary = i > 0 && i <= 2 * n;
+        dlx->left[i] = primary || i == 0 ? i - 1 : i;
+        dlx->right[i] = primary || i == 0 ? i + 1 : i;
+    }
+    dlx->left[0] = 2 * n;
+    dlx->right[2 * n] = 0;
+
+    int next = items + 1;
+    for (int row = 0; row < n; row++) {
+        for (int col = 0; col < n; col++) {
+            int headers[4] = {1 + row, 1 + n + col, 1 + 2 * n + row + col, 1 + 2 * n + (2 * n - 1) + row - col + n - 1};
+            for (int k = 0; k < 4; k++) {
+                int node = next + k;
+                int header = headers[k];
+                dlx->item[node] = header;
+                dlx->square[node] = row * n + col;
+                dlx->up[node] = dlx->up[header];
+                dlx->down[node] = header;
+                dlx->down[dlx->up[header]] = node;
+                dlx->up[header] = node;
+                dlx->size[header]++;
+                dlx->left[node] = next + (k + 3) % 4;
+                dlx->right[node] = next + (k + 1) % 4;
+            }
+            next += 4;
+        }
+    }
+}
+
+static void dlx_cover(DlxSearch *dlx, int header) {
+    int *left = dlx->left, *right = dlx->right, *up = dlx->up, *down = dlx->down;
+    long long updates = 0;
+    right[left[header]] = right[header];
+    left[right[header]] = left[header];
+    for (int option = down[header]; option != header; option = down[option]) {
+        for (int node = right[option]; node != option; node = right[node]) {
+            up[down[node]] = up[node];
+            down[up[node]] = down[node];
+            dlx->size[dlx->item[node]]--;
+            updates++;
+        }
+    }
+    dlx->out->stats.updates += updates;
+}
+
+static void dlx_uncover(DlxSearch *dlx, int header) {
+    int *left = dlx->left, *right = dlx->right, *up = dlx->up, *down = dlx->down;
+    for (int option = up[header]; option != header; option = up[option]) {
+        for (int node = left[option]; node != option; node = left[node]) {
+            dlx->size[dlx->item[node]]++;
+            up[down[node]] = node;
+            down[up[node]] = node;
+        }
+    }
+    right[left[header]] = header;
+    left[right[header]] = header;
+}
+
+/* Algorithm X: cover the primary item with the fewest options left, try each of its
+ * options in turn, and undo the links on the way back. */
+static void dlx_search(DlxSearch *dlx, int depth) {
+    SolverOutput *out = dlx->out;
+    if (dlx->right[0] == 0) {
+        out->stats.leaves++;
+        out->solution_count++;
+        solver_output_emit(out, dlx->placement);
+        return;
+    }
+
+    int best = dlx->right[0];
+    for (int header = dlx->right[best]; header != 0; header = dlx->right[header]) {
+        if (dlx->size[header] < dlx->size[best]) best = header;
+    }
+    if (dlx->size[best] == 0) {
+        out->stats.pruned++;
+        return;
+    }
+
+    int branch = 0;
+    int branch_count = dlx->size[best];
+    dlx_cover(dlx, best);
+    for (int option = dlx->down[best]; option != best && !out->stopped; option = dlx->down[option]) {
+        if (depth < PROGRESS_DEPTH) solver_output_branch(out, depth, branch++, branch_count);
+        solver_output_count_node(out, depth);
+        int square = dlx->square[option];
+        dlx->placement[square % dlx->n] = (unsigned char)(square / dlx->n);
+
+        for (int node = dlx->right[option]; node != option; node = dlx->right[node]) dlx_cover(dlx, dlx->item[node]);
+        dlx_search(dlx, depth + 1);
+        for (int node = dlx->left[option]; node != option; node = dlx->left[node]) dlx_uncover(dlx, dlx->item[node]);
+    }
+    dlx_uncover(dlx, best);
+}
+
+/* Enumerates every solution; operations count the options tried, as the bitboard
+ * engine counts queens placed, and the link updates go to the statistics. */
+void solve_n_queens_dlx(int n, SolverOutput *out) {
+    if (n < 1 || n > BITBOARD_MAX_SIZE) return;
+
+    DlxSearch dlx;
+    dlx_init(&dlx, n, out);
+    dlx_search(&dlx, 0);
+    free(dlx.left);
+}
+
+static inline uint64_t rng_next(uint64_t *state) {
+    uint64_t x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 0x2545f4914f6cdd1dull;
+}
+
+static inline uint32_t rng_below(uint64_t *state, uint32_t bound) {
+    return (uint32_t)(((rng_next(state) >> 32) * bound) >> 32);
+}
+
+/* Min-conflicts keeps the queens as a row permutation, so only the diagonals can clash;
+ * the counters and conflict total are the same DiagonalState the exhaustive mode uses. */
+typedef struct {
+    int n;
+    uint32_t *rows;
+    DiagonalState diagonals;
+    int *suspects;
+    unsigned char *queued;
+    uint64_t rng;
+    SolverOutput *out;
+} MinConflictsSearch;
+
+static void swap_columns_wide(DiagonalState *state, uint32_t *rows, int a, int b) {
+    diagonal_place(state, rows[a], a, -1);
+    diagonal_place(state, rows[b], b, -1);
+    uint32_t row = rows[a];
+    rows[a] = rows[b];
+    rows[b] = row;
+    diagonal_place(state, rows[a], a, +1);
+    diagonal_place(state, rows[b], b, +1);
+}
+
+static inline bool is_attacked(const MinConflictsSearch *search, int col) {
+    int row = search->rows[col];
+    return search->diagonals.rising[row + col] > 1
+        || search->diagonals.falling[row - col + search->n - 1] > 1;
+}
+
+/* Greedy start: each column takes a random unused row whose diagonals are still free,
+ * giving up after a few tries; the last few columns are filled at random. This leaves
+ * only a handful of attacked queens for the repair phase. */
+static void min_conflicts_initialise(MinConflictsSearch *search) {
+    int n = search->n;
+    DiagonalState *diagonals = &search->diagonals;
+    memset(diagonals->rising, 0, (2 * (size_t)n - 1) * sizeof(int));
+    memset(diagonals->falling, 0, (2 * (size_t)n - 1) * sizeof(int));
+    diagonals->conflicts = 0;
+    for (int i = 0; i < n; i++) search->rows[i] = i;
+
+    for (int col = 0; col < n && !search->out->stopped; col++) {
+        int pick = col + rng_below(&search->rng, n - col);
+        if (col < n - MIN_CONFLICTS_RANDOM_TAIL) {
+            for (int attempt = 0; attempt < MIN_CONFLICTS_INIT_ATTEMPTS; attempt++) {
+                int row = search->rows[pick];
+                if (diagonals->rising[row + col] == 0 && diagonals->falling[row - col + n - 1] == 0) break;
+                pick = col + rng_below(&search->rng, n - col);
+            }
+        }
+        uint32_t row = search->rows[pick];
+        search->rows[pick] = search->rows[col];
+        search->rows[col] = row;
+        diagonal_place(diagonals, row, col, +1);
+        solver_output_count_operation(search->out);
+        if ((col & 0xfff) == 0) solver_output_branch(search->out, 0, col, n);
+    }
+}
+
+static void queue_suspect(MinConflictsSearch *search, int *count, int col) {
+    if (search->queued[col]) return;
+    search->queued[col] = 1;
+    search->suspects[(*count)++] = col;
+}
+
+/* Repair: every attacked queen tries MIN_CONFLICTS_SAMPLES random swap partners and
+ * takes the one leaving the fewest conflicts, as long as that is no worse than the
+ * current board (sideways moves let it walk off plateaus).
+ * Returns false when the step budget runs out so the caller can restart. */
+static bool min_conflicts_repair(MinConflictsSearch *search, long long budget) {
+    int n = search->n;
+    DiagonalState *diagonals = &search->diagonals;
+    int count = 0;
+
+    for (int col = 0; col < n; col++) {
+        search->queued[col] = 0;
+        if (is_attacked(search, col)) queue_suspect(search, &count, col);
+    }
+
+    while (diagonals->conflicts > 0 && !search->out->stopped) {
+        if (count == 0) {
+            for (int col = 0; col < n; col++) {
+                if (is_attacked(search, col)) queue_suspect(search, &count, col);
+            }
+        }
+        int col = search->suspects[--count];
+        search->queued[col] = 0;
+        if (!is_attacked(search, col)) continue;
+        if (--budget < 0) return false;
+
+        int best_partner = -1;
+        int best_conflicts = diagonals->conflicts;
+        for (int s = 0; s < MIN_CONFLICTS_SAMPLES; s++) {
+            int partner = rng_below(&search->rng, n);
+            if (partner == col) continue;
+            swap_columns_wide(diagonals, search->rows, col, partner);
+            if (diagonals->conflicts < best_conflicts
+                || (best_partner < 0 && diagonals->conflicts == best_conflicts)) {
+                best_conflicts = diagonals->conflicts;
+                best_partner = partner;
+            }
+            swap_columns_wide(diagonals, search->rows, col, partner);
+            solver_output_count_operation(search->out);
+        }
+
+        if (best_partner >= 0) {
+            swap_columns_wide(diagonals, search->rows, col, best_partner);
+            if (is_attacked(search, best_partner)) queue_suspect(search, &count, best_partner);
+        }
+        if (is_attacked(search, col)) queue_suspect(search, &count, col);
+    }
+    return diagonals->conflicts == 0;
+}
+
+/* Independent O(n) check of the final board: one queen per row and per diagonal. */
+static bool verify_placement_wide(const uint32_t *rows, int n, DiagonalState *scratch, unsigned char *seen) {
+    memset(seen, 0, (size_t)n);
+    memset(scratch->rising, 0, (2 * (size_t)n - 1) * sizeof(int));
+    memset(scratch->falling, 0, (2 * (size_t)n - 1) * sizeof(int));
+    for (int col = 0; col < n; col++) {
+        uint32_t row = rows[col];
+        if (row >= (uint32_t)n || seen[row]) return false;
+        seen[row] = 1;
+        if (scratch->rising[row + col]++ || scratch->falling[row - col + n - 1]++) return false;
+    }
+    return true;
+}
+
+/* "Find one solution fast" mode for very large boards: min-conflicts heuristic repair
+ * from a greedy start, restarting from a fresh random board when a repair stalls.
+ * Memory is O(n): the row array, two diagonal counter arrays and the suspect list.
+ * The run is reproducible for a given solver_seed. */
+bool solve_n_queens_min_conflicts(int n, SolverOutput *out) {
+    if (n < 1 || n > MIN_CONFLICTS_MAX_SIZE) return false;
+    if (n == 2 || n == 3) return false;
+
+    MinConflictsSearch search = {.n = n, .rng = solver_seed ? solver_seed : MIN_CONFLICTS_DEFAULT_SEED, .out = out};
+    search.rows = malloc((size_t)n * sizeof(uint32_t));
+    search.diagonals.n = n;
+    search.diagonals.rising = malloc((2 * (size_t)n - 1) * sizeof(int));
+    search.diagonals.falling = malloc((2 * (size_t)n - 1) * sizeof(int));
+    search.suspects = malloc((size_t)n * sizeof(int));
+    search.queued = malloc((size_t)n);
+
+    bool solved = false;
+    for (int restart = 0; restart < MIN_CONFLICTS_MAX_RESTARTS && !solved && !out->stopped; restart++) {
+        uint64_t setup_start = monotonic_ns();
+        min_conflicts_initialise(&search);
+        out->stats.phase_ns[SOLVER_PHASE_SETUP] += monotonic_ns() - setup_start;
+        solver_output_branch(out, 0, n - 1, n);
+        solved = min_conflicts_repair(&search, 8LL * n + 1000);
+        if (!solved) out->stats.pruned++;
+    }
+
+    if (solved) {
+        uint32_t *rows = search.rows;
+        out->stats.leaves++;
+        solved = verify_placement_wide(rows, n, &search.diagonals, search.queued);
+        if (solved) {
+            out->solution_count = 1;
+            if (out->width == 1) {
+                for (int col = 0; col < n; col++) search.queued[col] = (unsigned char)rows[col];
+                solver_output_emit(out, search.queued);
+            } else {
+                solver_output_emit(out, rows);
+            }
+        }
+    }
+
+    free(search.rows);
+    free(search.diagonals.rising);
+    free(search.diagonals.falling);
+    free(search.suspects);
+    free(search.queued);
+    return solved;
+}
+
+/* Largest board each method accepts: the exact engines work on 32-bit masks. */
+int method_max_size(SolverMethod method) {
+    return method == METHOD_MIN_CONFLICTS ? MIN_CONFLICTS_MAX_SIZE : BITBOARD_MAX_SIZE;
+}
+
+/* The intuitive engine is the only one that works on an n x n board of ints. */
+static void run_intuitive(int size, SolverOutput *out) {
+    int **board = malloc(size * sizeof(int *));
+    for (int i = 0; i < size; i++) {
+        board[i] = calloc(size, sizeof(int));
+    }
+
+    if (solve_n_queens_intuitive(board, 0, size, out)) {
+        unsigned char placement[BITBOARD_MAX_SIZE] = {0};
+        board_to_placement(board, size, placement);
+        out->solution_count = 1;
+        solver_output_emit(out, placement);
+    }
+
+    for (int i = 0; i < size; i++) {
+        free(board[i]);
+    }
+    free(board);
+}
+
+/* Runs one solve of the given method to completion, reporting through out. */
+void run_solver(SolverMethod method, int size, SolverOutput *out) {
+    if (size < 1 || size > method_max_size(method)) return;
+
+    switch (method) {
+        case METHOD_INTUITIVE:
+            run_intuitive(size, out);
+            break;
+        case METHOD_ARBORESCENT:
+            solve_n_queens_arborescent(size, out);
+            break;
+        case METHOD_EXHAUSTIVE:
+            generate_all_configurations(size, out);
+            break;
+        case METHOD_BITBOARD:
+            solve_n_queens_bitboard(size, out);
+            break;
+        case METHOD_PARALLEL:
+            count_n_queens_parallel(size, 0, out);
+            break;
+        case METHOD_SYMMETRIC:
+            solve_n_queens_symmetric(size, out);
+            break;
+        case METHOD_MIN_CONFLICTS:
+            solve_n_queens_min_conflicts(size, out);
+            break;
+        case METHOD_DLX:
+            solve_n_queens_dlx(size, out);
+            break;
+        case METHOD_LOCKSTEP:
+            count_n_queens_lockstep(size, out);
+            break;
+        default:
+            break;
+    }
+}
+
+/* Public API (nqueens.h). The engine and status enums mirror SolverMethod and the run's
+ * outcome; a context owns one cancel flag that every run on it polls. The flag is only
+ * cleared when a run ends, so a request made while a run is still starting is kept. */
+_Static_assert((int)NQ_ENGINE_COUNT == (int)METHOD_COUNT, "nq_engine must mirror SolverMethod");
+_Static_assert(NQ_MAX_EXACT_SIZE == BITBOARD_MAX_SIZE, "NQ_MAX_EXACT_SIZE must match BITBOARD_MAX_SIZE");
+
+struct nq_context {
+    int n;
+    atomic_bool cancel;
+    SolverStats stats;
+    long long solutions;
+    long long operations;
+    uint32_t *rows; /* callback scratch, n entries */
+    nq_solution_fn on_solution;
+    void *user_data;
+};
+
+struct nq_iterator {
+    nq_context *ctx;
+    SolutionIterator it;
+    unsigned char placement[BITBOARD_MAX_SIZE];
+};
+
+int nq_api_version(void) {
+    return NQ_API_VERSION;
+}
+
+nq_context *nq_context_new(int n) {
+    if (n < 1) return NULL;
+    nq_context *ctx = calloc(1, sizeof(nq_context));
+    if (!ctx) return NULL;
+    ctx->rows = malloc((size_t)n * sizeof(uint32_t));
+    if (!ctx->rows) {
+        free(ctx);
+        return NULL;
+    }
+    ctx->n = n;
+    atomic_init(&ctx->cancel, false);
+    return ctx;
+}
+
+void nq_context_free(nq_context *ctx) {
+    if (!ctx) return;
+    free(ctx->rows);
+    free(ctx);
+}
+
+int nq_context_size(const nq_context *ctx) {
+    return ctx->n;
+}
+
+void nq_cancel(nq_context *ctx) {
+    atomic_store(&ctx->cancel, true);
+}
+
+const char *nq_engine_name(nq_engine engine) {
+    return engine >= 0 && engine < NQ_ENGINE_COUNT ? method_names[engine] : NULL;
+}
+
+nq_status nq_engine_from_name(const char *name, nq_engine *engine) {
+    for (int m = 0; m < METHOD_COUNT; m++) {
+        if (strcmp(name, method_names[m]) == 0) {
+            *engine = (nq_engine)m;
+            return NQ_OK;
+        }
+    }
+    return NQ_ERROR_ARGUMENT;
+}
+
+int nq_engine_max_size(nq_engine engine) {
+    return engine >= 0 && engine < NQ_ENGINE_COUNT ? method_max_size((SolverMethod)engine) : 0;
+}
+
+static bool deliver_solution(void *data, const void *placement) {
+    nq_context *ctx = data;
+    int width = placement_width(ctx->n);
+    for (int c = 0; c < ctx->n; c++) ctx->rows[c] = (uint32_t)placement_row(placement, width, c);
+    return ctx->on_solution(ctx->rows, ctx->n, ctx->user_data) == 0;
+}
+
+static nq_status run_engine(nq_context *ctx, nq_engine engine, nq_solution_fn on_solution, void *user_data) {
+    if (!ctx || engine < 0 || engine >= NQ_ENGINE_COUNT || ctx->n > method_max_size((SolverMethod)engine)) {
+        return NQ_ERROR_ARGUMENT;
+    }
+
+    SolverOutput out;
+    solver_output_init(&out, NULL, ctx->n);
+    out.cancel = &ctx->cancel;
+    if (on_solution) {
+        ctx->on_solution = on_solution;
+        ctx->user_data = user_data;
+        out.sink = deliver_solution;
+        out.sink_data = ctx;
+    }
+
+    run_solver((SolverMethod)engine, ctx->n, &out);
+    atomic_store(&ctx->cancel, false);
+
+    ctx->solutions = out.solution_count;
+    ctx->operations = out.operation_count;
+    solver_output_snapshot_stats(&out, &ctx->stats);
+    ctx->on_solution = NULL;
+    ctx->user_data = NULL;
+    return out.stopped ? NQ_CANCELLED : NQ_OK;
+}
+
+nq_status nq_solve(nq_context *ctx, nq_engine engine, nq_solution_fn on_solution, void *user_data) {
+    return run_engine(ctx, engine, on_solution, user_data);
+}
+
+nq_status nq_count(nq_context *ctx, nq_engine engine, uint64_t *count) {
+    nq_status status = run_engine(ctx, engine, NULL, NULL);
+    if (status != NQ_ERROR_ARGUMENT && count) *count = (uint64_t)ctx->solutions;
+    return status;
+}
+
+void nq_get_stats(const nq_context *ctx, nq_stats *stats) {
+    memset(stats, 0, sizeof(*stats));
+    for (int c = 0; c < NQ_MAX_EXACT_SIZE; c++) stats->nodes[c] = (uint64_t)ctx->stats.nodes[c];
+    stats->pruned = (uint64_t)ctx->stats.pruned;
+    stats->leaves = (uint64_t)ctx->stats.leaves;
+    stats->updates = (uint64_t)ctx->stats.updates;
+    stats->solutions = (uint64_t)ctx->solutions;
+    stats->operations = (uint64_t)ctx->operations;
+    stats->setup_ns = ctx->stats.phase_ns[SOLVER_PHASE_SETUP];
+    stats->search_ns = ctx->stats.phase_ns[SOLVER_PHASE_SEARCH];
+    stats->publish_ns = ctx->stats.phase_ns[SOLVER_PHASE_PUBLISH];
+}
+
+nq_iterator *nq_iterator_new(nq_context *ctx) {
+    if (!ctx || ctx->n > BITBOARD_MAX_SIZE) return NULL;
+    nq_iterator *it = calloc(1, sizeof(nq_iterator));
+    if (!it) return NULL;
+    it->ctx = ctx;
+    solution_iterator_init(&it->it, ctx->n);
+    memset(&ctx->stats, 0, sizeof(ctx->stats));
+    return it;
+}
+
+/* Steps the search in slices so nq_cancel can interrupt a long gap between solutions. */
+nq_status nq_iterator_next(nq_iterator *it, uint32_t *rows) {
+    nq_context *ctx = it->ctx;
+    IteratorStatus status;
+    while ((status = solution_iterator_next(&it->it, it->placement, ITERATOR_SLICE)) == ITERATOR_PAUSED) {
+        if (atomic_load_explicit(&ctx->cancel, memory_order_relaxed)) break;
+    }
+    atomic_store(&ctx->cancel, false);
+
+    ctx->solutions = it->it.solutions;
+    ctx->operations = it->it.operations;
+    if (status == ITERATOR_PAUSED) return NQ_CANCELLED;
+    if (status == ITERATOR_EXHAUSTED) return NQ_DONE;
+    for (int c = 0; c < ctx->n; c++) rows[c] = it->placement[c];
+    return NQ_OK;
+}
+
+void nq_iterator_free(nq_iterator *it) {
+    free(it);
+}
@@ -0,0 +1,107 @@
+/* libnqueens: the N-queens engines behind the solver, usable without GTK.
+ *
+ * A context fixes the board size and keeps the results of the last run made with it.
+ * Runs are synchronous. A context must not be used from two threads at once, except
+ * for nq_cancel, which any thread may call while a run is in progress.
+ *
+ * Rows are reported per column: rows[c] is the row of the queen in column c. */
+#ifndef NQUEENS_H
+#define NQUEENS_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(NQUEENS_BUILDING) && defined(__GNUC__)
+#define NQ_API __attribute__((visibility("default")))
+#else
+#define NQ_API
+#endif
+
+/* Bumped whenever a declaration below changes incompatibly. */
+#define NQ_API_VERSION 1
+
+/* Largest board every engine except min-conflicts accepts. */
+#define NQ_MAX_EXACT_SIZE 32
+
+typedef enum {
+    NQ_ENGINE_INTUITIVE,    /* first solution by plain backtracking */
+    NQ_ENGINE_ARBORESCENT,  /* first solution, leaves validated in SIMD batches */
+    NQ_ENGINE_EXHAUSTIVE,   /* all solutions by permutation enumeration */
+    NQ_ENGINE_BITBOARD,     /* all solutions, bitmask backtracking */
+    NQ_ENGINE_PARALLEL,     /* count only, on every hardware thread */
+    NQ_ENGINE_SYMMETRIC,    /* one solution per symmetry class */
+    NQ_ENGINE_MIN_CONFLICTS, /* one solution by local search, for very large n */
+    NQ_ENGINE_DLX,          /* all solutions, Dancing Links exact cover */
+    NQ_ENGINE_LOCKSTEP,     /* count only, SIMD lanes on the calling thread */
+    NQ_ENGINE_COUNT
+} nq_engine;
+
+typedef enum {
+    NQ_OK = 0,
+    NQ_DONE = 1,       /* an iterator has no more solutions */
+    NQ_CANCELLED = 2,  /* stopped by nq_cancel or by the solution callback */
+    NQ_ERROR_ARGUMENT = -1
+} nq_status;
+
+/* Statistics of the last run; see nq_get_stats. nodes[c] counts queens placed in
+ * column c. pruned counts dead ends and leaves complete boards checked. updates counts
+ * DLX link changes. Times are in nanoseconds. */
+typedef struct {
+    uint64_t nodes[NQ_MAX_EXACT_SIZE];
+    uint64_t pruned;
+    uint64_t leaves;
+    uint64_t updates;
+    uint64_t solutions;
+    uint64_t operations;
+    uint64_t setup_ns;
+    uint64_t search_ns;
+    uint64_t publish_ns;
+} nq_stats;
+
+/* Called for each solution found; rows is only valid during the call. Returning
+ * non-zero stops the run. */
+typedef int (*nq_solution_fn)(const uint32_t *rows, int n, void *user_data);
+
+typedef struct nq_context nq_context;
+typedef struct nq_iterator nq_iterator;
+
+NQ_API int nq_api_version(void);
+
+/* NULL when n is not positive or allocation fails. */
+NQ_API nq_context *nq_context_new(int n);
+NQ_API void nq_context_free(nq_context *ctx);
+NQ_API int nq_context_size(const nq_context *ctx);
+
+/* Stops the run in progress on ctx, which then returns NQ_CANCELLED. A request that
+ * arrives before a run has started is kept and stops that run at its first check. */
+NQ_API void nq_cancel(nq_context *ctx);
+
+/* Short names as used by the command line, e.g. "bitboard". */
+NQ_API const char *nq_engine_name(nq_engine engine);
+NQ_API nq_status nq_engine_from_name(const char *name, nq_engine *engine);
+NQ_API int nq_engine_max_size(nq_engine engine);
+
+/* Runs engine on ctx and calls on_solution (may be NULL) for each solution it emits.
+ * The counting engines emit none; the symmetric engine emits one per class. */
+NQ_API nq_status nq_solve(nq_context *ctx, nq_engine engine, nq_solution_fn on_solution, void *user_data);
+
+/* Runs engine on ctx and stores the number of solutions it found in *count. */
+NQ_API nq_status nq_count(nq_context *ctx, nq_engine engine, uint64_t *count);
+
+NQ_API void nq_get_stats(const nq_context *ctx, nq_stats *stats);
+
+/* Every solution of the context's size in lexicographic order, one at a time, in
+ * O(n) memory. NULL when the size exceeds NQ_MAX_EXACT_SIZE. */
+NQ_API nq_iterator *nq_iterator_new(nq_context *ctx);
+/* Fills rows[0..n-1] and returns NQ_OK, or returns NQ_DONE or NQ_CANCELLED. */
+NQ_API nq_status nq_iterator_next(nq_iterator *it, uint32_t *rows);
+NQ_API void nq_iterator_free(nq_iterator *it);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
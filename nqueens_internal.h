@@ -0,0 +1,262 @@
+/* Interface shared by libnqueens and the front ends built with it (the GTK window and
+ * the command-line modes): engine internals, streaming output and the solution store.
+ * Not installed and not part of the stable API in nqueens.h. */
+#ifndef NQUEENS_INTERNAL_H
+#define NQUEENS_INTERNAL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#ifndef MIN
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+#ifndef MAX
+#define MAX(a, b) (((a) > (b)) ? (a) : (b))
+#endif
+
+#define BITBOARD_MAX_SIZE 32
+#define SOLUTION_QUEUE_SLOTS 64
+#define PROGRESS_DEPTH 2
+#define MIN_CONFLICTS_MAX_SIZE 10000000
+#define VALIDATE_BATCH 32
+
+typedef enum {
+    METHOD_INTUITIVE,
+    METHOD_ARBORESCENT,
+    METHOD_EXHAUSTIVE,
+    METHOD_BITBOARD,
+    METHOD_PARALLEL,
+    METHOD_SYMMETRIC,
+    METHOD_MIN_CONFLICTS,
+    METHOD_DLX,
+    METHOD_LOCKSTEP,
+    METHOD_COUNT
+} SolverMethod;
+
+/* Solutions kept as row-per-column permutations in one contiguous arena, one byte per
+ * row up to 256 columns and a uint32_t per row beyond (see placement_width). */
+typedef struct {
+    unsigned char *data;
+    const unsigned char *mapped; /* read-only placements borrowed from the solution cache */
+    size_t count;
+    size_t capacity; /* bytes */
+    size_t limit;
+    size_t stride;
+    int width;
+    int n;
+    bool truncated;
+} SolutionStore;
+
+typedef enum {
+    SOLVER_PHASE_SETUP,
+    SOLVER_PHASE_SEARCH,
+    SOLVER_PHASE_PUBLISH,
+    SOLVER_PHASE_COUNT
+} SolverPhase;
+
+/* Search instrumentation. Every thread fills its own copy without synchronisation;
+ * copies are merged by the thread that owns the SolverOutput and travel to the UI
+ * inside a published batch, so a reader always sees one consistent snapshot.
+ * nodes[d] counts queens placed at depth d, which is column d for the engines that
+ * fill columns in order (lockstep only splits them inside its prefix; the rest are
+ * in the operation count); pruned counts dead ends (partial boards with no safe square,
+ * rejected placements, or abandoned min-conflicts restarts); leaves counts complete
+ * boards checked; updates counts DLX link changes. */
+typedef struct {
+    long long nodes[BITBOARD_MAX_SIZE];
+    long long pruned;
+    long long leaves;
+    long long updates;
+    long long solutions;
+    uint64_t phase_ns[SOLVER_PHASE_COUNT];
+} SolverStats;
+
+/* A batch of solutions found by the solver, with its running totals at publish time. */
+typedef struct {
+    unsigned char *placements;
+    int count;
+    int capacity;
+    long long solution_count;
+    long long operation_count;
+    SolverStats stats;
+    double progress;
+    bool finished;
+    bool cancelled;
+} SolutionBatch;
+
+/* Lock-free single-producer/single-consumer ring: the solver thread pushes, the GTK main loop pops. */
+typedef struct {
+    SolutionBatch *slots[SOLUTION_QUEUE_SLOTS];
+    atomic_size_t head;
+    atomic_size_t tail;
+} SolutionQueue;
+
+/* The partial board a running search is exploring, for display. depth is the number of
+ * columns filled in placement, 0 for engines that keep no board (the counting engines
+ * and DLX); nodes are the run's per-column counts so far. */
+typedef struct {
+    int depth;
+    unsigned char placement[BITBOARD_MAX_SIZE];
+    long long nodes[BITBOARD_MAX_SIZE];
+} SearchFrame;
+
+/* Double-buffered seqlock: the solver writes the older frame under its sequence (odd
+ * while writing) and then bumps published, so it never waits and a reader only retries
+ * when its copy was overwritten, which takes two more publishes. */
+typedef struct {
+    SearchFrame frames[2];
+    atomic_uint sequence[2];
+    atomic_uint published; /* frames written so far; the newest is frames[(published - 1) & 1] */
+} SearchSnapshot;
+
+typedef struct {
+    SolutionQueue *queue;
+    SolutionBatch *pending;
+    FILE *dump;
+    const char *dump_label;
+    bool (*sink)(void *data, const void *placement); /* optional; returning false stops the run */
+    void *sink_data;
+    SearchSnapshot *snapshot; /* optional; refreshed from solver_output_poll */
+    const unsigned char *trace_placement; /* the engine's board, NULL if it keeps none */
+    int trace_depth;
+    uint64_t last_snapshot_ns;
+    int n;
+    int width;
+    size_t stride;
+    long long solution_count;
+    long long operation_count;
+    SolverStats stats;
+    uint64_t start_ns;
+    int poll_countdown;
+    bool first_published;
+    uint64_t last_flush_ns;
+    const atomic_bool *cancel;
+    const atomic_bool *detached; /* set when the consumer has gone away */
+    bool stopped;
+    int branch_index[PROGRESS_DEPTH];
+    int branch_count[PROGRESS_DEPTH];
+} SolverOutput;
+
+/* Memoised subtree solution counts for unranking, keyed by board state. */
+typedef struct {
+    uint32_t rows;
+    uint32_t ld;
+    uint32_t rd;
+    int depth; /* 0 marks an empty slot, otherwise depth + 1 */
+    long long count;
+} SubtreeCount;
+
+typedef struct {
+    int n;
+    uint32_t all;
+    SubtreeCount *entries;
+    size_t capacity; /* power of two */
+    size_t used;
+} SolutionIndex;
+
+typedef enum {
+    ITERATOR_FOUND,
+    ITERATOR_PAUSED,
+    ITERATOR_EXHAUSTED
+} IteratorStatus;
+
+typedef struct {
+    int n;
+    int depth; /* columns placed; -1 once the tree is exhausted */
+    uint32_t all;
+    uint32_t rows[BITBOARD_MAX_SIZE + 1];
+    uint32_t ld[BITBOARD_MAX_SIZE + 1];
+    uint32_t rd[BITBOARD_MAX_SIZE + 1];
+    uint32_t available[BITBOARD_MAX_SIZE + 1];
+    unsigned char placement[BITBOARD_MAX_SIZE];
+    long long operations;
+    long long solutions;
+} SolutionIterator;
+
+/* User constraints on a partial board: pinned[c] is the row of a queen fixed in
+ * column c (-1 when free) and bit r of blocked[c] bars square (r, c). */
+typedef struct {
+    int n;
+    int pinned[BITBOARD_MAX_SIZE];
+    uint32_t blocked[BITBOARD_MAX_SIZE];
+} BoardConstraints;
+
+typedef struct {
+    uint32_t rows;
+    uint32_t ld;
+    uint32_t rd;
+} PrefixTask;
+
+typedef struct {
+    long long operations;
+    const atomic_bool *cancel;
+    bool stopped;
+    SolverStats *stats; /* optional, per thread */
+} CountState;
+
+typedef long long (*CountKernel)(uint32_t all, uint32_t rows, uint32_t ld, uint32_t rd, CountState *state);
+
+static inline int placement_width(int n) {
+    return n <= 256 ? 1 : (int)sizeof(uint32_t);
+}
+
+static inline int placement_row(const unsigned char *placement, int width, int col) {
+    if (width == 1) return placement[col];
+    uint32_t row;
+    memcpy(&row, placement + (size_t)col * width, sizeof(row));
+    return (int)row;
+}
+
+
+extern const char *method_names[METHOD_COUNT];
+extern uint64_t solver_seed;
+extern bool use_specialized_kernels;
+
+uint64_t monotonic_ns(void);
+int hardware_thread_count(void);
+
+void solution_store_reset(SolutionStore *store, int n);
+bool solution_store_append(SolutionStore *store, const void *placement);
+const unsigned char *solution_store_get(const SolutionStore *store, size_t index);
+int solution_store_row(const SolutionStore *store, size_t index, int col);
+
+SolutionBatch *solution_queue_pop(SolutionQueue *queue);
+void solution_batch_free(SolutionBatch *batch);
+
+void solver_output_init(SolverOutput *out, SolutionQueue *queue, int n);
+void search_snapshot_init(SearchSnapshot *snapshot);
+bool search_snapshot_read(SearchSnapshot *snapshot, SearchFrame *frame);
+void solver_output_snapshot_stats(const SolverOutput *out, SolverStats *stats);
+void solver_output_finish(SolverOutput *out);
+void write_stats_json(FILE *file, const SolverStats *stats, int n);
+void write_stats_csv(FILE *file, const SolverStats *stats, int n);
+
+int method_max_size(SolverMethod method);
+void run_solver(SolverMethod method, int size, SolverOutput *out);
+
+void transform_placement(const unsigned char *src, unsigned char *dst, int n, int symmetry);
+bool is_distinct_image(const unsigned char *placement, int n, int symmetry);
+void validate_candidates(const unsigned char *candidates, int count, int n, unsigned char *valid);
+
+long long bitboard_count(uint32_t all, uint32_t rows, uint32_t ld, uint32_t rd, CountState *state);
+CountKernel select_count_kernel(int n);
+void collect_prefix_tasks(uint32_t all, int depth, uint32_t rows, uint32_t ld, uint32_t rd,
+                          PrefixTask *tasks, int *task_count, long long *operation_count,
+                          SolverStats *stats);
+
+void solution_iterator_init(SolutionIterator *it, int n);
+IteratorStatus solution_iterator_next(SolutionIterator *it, unsigned char *placement, long long budget);
+
+void solution_index_reset(SolutionIndex *index, int n);
+void solution_index_free(SolutionIndex *index);
+long long solution_index_known_total(const SolutionIndex *index);
+bool solution_index_unrank(SolutionIndex *index, long long rank, unsigned char *placement, CountState *state);
+
+void board_constraints_reset(BoardConstraints *constraints, int n);
+bool complete_board(const BoardConstraints *constraints, unsigned char *placement, CountState *state);
+
+#endif
@@ -0,0 +1,288 @@
+/* Checks the engine internals of nqueens_internal.h against plain reference code: the
+ * resumable iterator, unranking, constrained completion, symmetric images and the
+ * batched leaf validation. Every size is small enough to enumerate by brute force. */
+#include "nqueens_internal.h"
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_REFERENCE_SIZE 10
+#define MAX_REFERENCE_SOLUTIONS 724
+
+static const int known_counts[] = {0, 1, 0, 0, 2, 10, 4, 40, 92, 352, 724};
+
+static int failures = 0;
+
+#define CHECK(cond, ...) \
+    do { \
+        if (!(cond)) { \
+            failures++; \
+            fprintf(stderr, "%s:%d: ", __FILE__, __LINE__); \
+            fprintf(stderr, __VA_ARGS__); \
+            fputc('\n', stderr); \
+        } \
+    } while (0)
+
+/* Every solution of one size in lexicographic order, found without any bitboard. */
+typedef struct {
+    int n;
+    int count;
+    unsigned char placements[MAX_REFERENCE_SOLUTIONS][MAX_REFERENCE_SIZE];
+} Reference;
+
+static uint64_t random_state = 0x2545f4914f6cdd1dull;
+
+static uint32_t next_random(void) {
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 7;
+    random_state ^= random_state << 17;
+    return (uint32_t)(random_state >> 32);
+}
+
+static bool is_solution(const unsigned char *rows, int n) {
+    for (int a = 0; a < n; a++) {
+        if (rows[a] >= n) return false;
+        for (int b = a + 1; b < n; b++) {
+            int distance = abs(rows[a] - rows[b]);
+            if (distance == 0 || distance == b - a) return false;
+        }
+    }
+    return true;
+}
+
+static void enumerate(Reference *reference, unsigned char *rows, int col) {
+    int n = reference->n;
+    if (col == n) {
+        memcpy(reference->placements[reference->count++], rows, n);
+        return;
+    }
+    for (int row = 0; row < n; row++) {
+        bool safe = true;
+        for (int other = 0; other < col && safe; other++) {
+            int distance = abs(rows[other] - row);
+            safe = distance != 0 && distance != col - other;
+        }
+        if (!safe) continue;
+        rows[col] = (unsigned char)row;
+        enumerate(reference, rows, col + 1);
+    }
+}
+
+static void build_reference(Reference *reference, int n) {
+    unsigned char rows[MAX_REFERENCE_SIZE];
+    reference->n = n;
+    reference->count = 0;
+    enumerate(reference, rows, 0);
+}
+
+/* The same sequence whether the iterator runs freely or pauses every few nodes. */
+static void test_iterator(const Reference *reference) {
+    const long long budgets[] = {LLONG_MAX, 1, 3, 7};
+    int n = reference->n;
+    for (size_t b = 0; b < sizeof(budgets) / sizeof(budgets[0]); b++) {
+        SolutionIterator it;
+        unsigned char placement[BITBOARD_MAX_SIZE];
+        int found = 0;
+        long long pauses = 0;
+        IteratorStatus status;
+        solution_iterator_init(&it, n);
+        while ((status = solution_iterator_next(&it, placement, budgets[b])) != ITERATOR_EXHAUSTED) {
+            if (status == ITERATOR_PAUSED) {
+                pauses++;
+                continue;
+            }
+            CHECK(found < reference->count && memcmp(placement, reference->placements[found], n) == 0,
+                  "n=%d budget %lld: solution %d differs from the reference", n, budgets[b], found);
+            found++;
+        }
+        CHECK(found == reference->count, "n=%d budget %lld: %d solutions, expected %d", n, budgets[b], found,
+              reference->count);
+        CHECK(it.solutions == reference->count, "n=%d budget %lld: iterator counted %lld", n, budgets[b],
+              it.solutions);
+        if (budgets[b] == 1 && n > 1) CHECK(pauses > 0, "n=%d: a budget of one node never paused", n);
+    }
+}
+
+/* Every rank, visited in a scrambled order so memoised counts are reused across the tree. */
+static void test_unrank(const Reference *reference) {
+    int n = reference->n;
+    int count = reference->count;
+    SolutionIndex index = {0};
+    solution_index_reset(&index, n);
+
+    int order[MAX_REFERENCE_SOLUTIONS];
+    for (int i = 0; i < count; i++) order[i] = i;
+    for (int i = count - 1; i > 0; i--) {
+        int j = (int)(next_random() % (uint32_t)(i + 1));
+        int swap = order[i];
+        order[i] = order[j];
+        order[j] = swap;
+    }
+
+    for (int i = 0; i < count; i++) {
+        unsigned char placement[BITBOARD_MAX_SIZE];
+        CountState state = {0, NULL, false, NULL};
+        bool found = solution_index_unrank(&index, order[i], placement, &state);
+        CHECK(found && memcmp(placement, reference->placements[order[i]], n) == 0,
+              "n=%d: rank %d does not match the reference", n, order[i]);
+    }
+
+    unsigned char placement[BITBOARD_MAX_SIZE];
+    CountState state = {0, NULL, false, NULL};
+    CHECK(!solution_index_unrank(&index, count, placement, &state), "n=%d: rank %d past the end was found", n, count);
+    CHECK(solution_index_known_total(&index) == count, "n=%d: known total %lld, expected %d", n,
+          solution_index_known_total(&index), count);
+    solution_index_free(&index);
+}
+
+static bool honours(const BoardConstraints *constraints, const unsigned char *placement) {
+    for (int col = 0; col < constraints->n; col++) {
+        if (constraints->pinned[col] >= 0 && placement[col] != constraints->pinned[col]) return false;
+        if (constraints->blocked[col] & (1u << placement[col])) return false;
+    }
+    return true;
+}
+
+/* Random pins and blocks, from none to a mostly filled board: a completion exists
+ * exactly when some reference solution honours them. */
+static void test_complete_board(const Reference *reference) {
+    int n = reference->n;
+    for (int trial = 0; trial < 400; trial++) {
+        BoardConstraints constraints;
+        board_constraints_reset(&constraints, n);
+        int pins = (int)(next_random() % (uint32_t)(n / 2 + 1));
+        int blocks = (int)(next_random() % (uint32_t)(2 * n + 1));
+        for (int i = 0; i < pins; i++) {
+            constraints.pinned[next_random() % (uint32_t)n] = (int)(next_random() % (uint32_t)n);
+        }
+        for (int i = 0; i < blocks; i++) {
+            constraints.blocked[next_random() % (uint32_t)n] |= 1u << (next_random() % (uint32_t)n);
+        }
+
+        bool expected = false;
+        for (int s = 0; s < reference->count && !expected; s++) {
+            expected = honours(&constraints, reference->placements[s]);
+        }
+
+        unsigned char placement[BITBOARD_MAX_SIZE];
+        CountState state = {0, NULL, false, NULL};
+        bool found = complete_board(&constraints, placement, &state);
+        CHECK(found == expected, "n=%d trial %d: completion %s, brute force %s", n, trial, found ? "found" : "missing",
+              expected ? "found" : "missing");
+        if (found) {
+            CHECK(is_solution(placement, n) && honours(&constraints, placement),
+                  "n=%d trial %d: completion breaks a rule or a constraint", n, trial);
+        }
+    }
+}
+
+static int find_solution(const Reference *reference, const unsigned char *placement) {
+    for (int s = 0; s < reference->count; s++) {
+        if (memcmp(reference->placements[s], placement, reference->n) == 0) return s;
+    }
+    return -1;
+}
+
+/* Expanding the smallest member of every class through its distinct images must give
+ * back each solution exactly once, which is what symmetric browsing relies on. */
+static void test_symmetric_expansion(const Reference *reference) {
+    int n = reference->n;
+    int seen[MAX_REFERENCE_SOLUTIONS] = {0};
+
+    for (int s = 0; s < reference->count; s++) {
+        const unsigned char *placement = reference->placements[s];
+        unsigned char image[BITBOARD_MAX_SIZE];
+        bool canonical = true;
+        for (int symmetry = 0; symmetry < 8; symmetry++) {
+            transform_placement(placement, image, n, symmetry);
+            CHECK(find_solution(reference, image) >= 0, "n=%d: image %d of solution %d is not a solution", n,
+                  symmetry, s);
+            if (memcmp(image, placement, n) < 0) canonical = false;
+        }
+        if (!canonical) continue;
+
+        for (int symmetry = 0; symmetry < 8; symmetry++) {
+            if (!is_distinct_image(placement, n, symmetry)) continue;
+            transform_placement(placement, image, n, symmetry);
+            int index = find_solution(reference, image);
+            if (index >= 0) seen[index]++;
+        }
+    }
+
+    for (int s = 0; s < reference->count; s++) {
+        CHECK(seen[s] == 1, "n=%d: solution %d produced %d times by the expansion", n, s, seen[s]);
+    }
+}
+
+static void validate_reference(const unsigned char *candidates, int count, int n, unsigned char *valid) {
+    for (int k = 0; k < count; k++) valid[k] = is_solution(candidates + k * n, n);
+}
+
+/* Random batches of every size and width, seeded with real solutions and near misses
+ * so both outcomes occur in most lanes. The solutions are the images of one completed
+ * board, so sizes past the reference are covered too. */
+static void test_validate_candidates(void) {
+    for (int n = 1; n <= BITBOARD_MAX_SIZE; n++) {
+        unsigned char images[8][BITBOARD_MAX_SIZE];
+        unsigned char solution[BITBOARD_MAX_SIZE];
+        int image_count = 0;
+        BoardConstraints constraints;
+        CountState state = {0, NULL, false, NULL};
+        board_constraints_reset(&constraints, n);
+        if (complete_board(&constraints, solution, &state)) {
+            for (int symmetry = 0; symmetry < 8; symmetry++) {
+                transform_placement(solution, images[image_count++], n, symmetry);
+            }
+        }
+
+        for (int trial = 0; trial < 200; trial++) {
+            unsigned char candidates[VALIDATE_BATCH * BITBOARD_MAX_SIZE];
+            unsigned char valid[VALIDATE_BATCH], expected[VALIDATE_BATCH];
+            int count = 1 + (int)(next_random() % VALIDATE_BATCH);
+
+            for (int k = 0; k < count; k++) {
+                unsigned char *rows = candidates + k * n;
+                if (image_count > 0 && next_random() % 2) {
+                    memcpy(rows, images[next_random() % (uint32_t)image_count], n);
+                    if (next_random() % 2) rows[next_random() % (uint32_t)n] = (unsigned char)(next_random() % n);
+                } else {
+                    for (int col = 0; col < n; col++) rows[col] = (unsigned char)col;
+                    for (int col = n - 1; col > 0; col--) {
+                        int other = (int)(next_random() % (uint32_t)(col + 1));
+                        unsigned char swap = rows[col];
+                        rows[col] = rows[other];
+                        rows[other] = swap;
+                    }
+                }
+            }
+
+            memset(valid, 0xff, sizeof(valid));
+            validate_candidates(candidates, count, n, valid);
+            validate_reference(candidates, count, n, expected);
+            for (int k = 0; k < count; k++) {
+                CHECK(!valid[k] == !expected[k], "n=%d trial %d: lane %d of %d says %d, expected %d", n, trial, k,
+                      count, valid[k], expected[k]);
+            }
+        }
+    }
+}
+
+int main(void) {
+    static Reference reference;
+    for (int n = 1; n <= MAX_REFERENCE_SIZE; n++) {
+        build_reference(&reference, n);
+        CHECK(reference.count == known_counts[n], "n=%d: reference found %d solutions", n, reference.count);
+        test_iterator(&reference);
+        test_unrank(&reference);
+        if (n <= 8) test_complete_board(&reference);
+        test_symmetric_expansion(&reference);
+    }
+    test_validate_candidates();
+    if (failures) {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,220 @@
+/* Checks libnqueens through its public API only: counts of every engine against the
+ * known totals, the iterator's order and coverage, early stops and statistics. */
+#include "nqueens.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const uint64_t known_counts[] = {0, 1, 0, 0, 2, 10, 4, 40, 92, 352, 724, 2680, 14200};
+
+static int failures = 0;
+
+#define CHECK(cond, ...) \
+    do { \
+        if (!(cond)) { \
+            failures++; \
+            fprintf(stderr, "%s:%d: ", __FILE__, __LINE__); \
+            fprintf(stderr, __VA_ARGS__); \
+            fputc('\n', stderr); \
+        } \
+    } while (0)
+
+static int is_solution(const uint32_t *rows, int n) {
+    for (int a = 0; a < n; a++) {
+        if (rows[a] >= (uint32_t)n) return 0;
+        for (int b = a + 1; b < n; b++) {
+            int distance = abs((int)rows[a] - (int)rows[b]);
+            if (distance == 0 || distance == b - a) return 0;
+        }
+    }
+    return 1;
+}
+
+static int comes_before(const uint32_t *a, const uint32_t *b, int n) {
+    for (int c = 0; c < n; c++) {
+        if (a[c] != b[c]) return a[c] < b[c];
+    }
+    return 0;
+}
+
+typedef struct {
+    uint64_t seen;
+    uint64_t invalid;
+    uint64_t stop_after;
+} Collector;
+
+static int collect(const uint32_t *rows, int n, void *user_data) {
+    Collector *collector = user_data;
+    collector->seen++;
+    if (!is_solution(rows, n)) collector->invalid++;
+    return collector->stop_after && collector->seen == collector->stop_after;
+}
+
+static void test_counts(void) {
+    const nq_engine exact[] = {NQ_ENGINE_EXHAUSTIVE, NQ_ENGINE_BITBOARD, NQ_ENGINE_PARALLEL,
+                               NQ_ENGINE_SYMMETRIC, NQ_ENGINE_DLX, NQ_ENGINE_LOCKSTEP};
+    for (int n = 1; n <= 12; n++) {
+        nq_context *ctx = nq_context_new(n);
+        for (size_t e = 0; e < sizeof(exact) / sizeof(exact[0]); e++) {
+            if (exact[e] == NQ_ENGINE_EXHAUSTIVE && n > 10) continue;
+            uint64_t count = 0;
+            nq_status status = nq_count(ctx, exact[e], &count);
+            CHECK(status == NQ_OK, "%s n=%d: status %d", nq_engine_name(exact[e]), n, status);
+            CHECK(count == known_counts[n], "%s n=%d: %llu solutions, expected %llu", nq_engine_name(exact[e]), n,
+                  (unsigned long long)count, (unsigned long long)known_counts[n]);
+        }
+        nq_context_free(ctx);
+    }
+}
+
+static void test_solutions_are_valid(void) {
+    nq_context *ctx = nq_context_new(8);
+    Collector collector = {0};
+    CHECK(nq_solve(ctx, NQ_ENGINE_BITBOARD, collect, &collector) == NQ_OK, "bitboard solve failed");
+    CHECK(collector.seen == 92 && collector.invalid == 0, "bitboard: %llu seen, %llu invalid",
+          (unsigned long long)collector.seen, (unsigned long long)collector.invalid);
+
+    collector = (Collector){0};
+    CHECK(nq_solve(ctx, NQ_ENGINE_DLX, collect, &collector) == NQ_OK, "dlx solve failed");
+    CHECK(collector.seen == 92 && collector.invalid == 0, "dlx: %llu seen", (unsigned long long)collector.seen);
+
+    collector = (Collector){0};
+    CHECK(nq_solve(ctx, NQ_ENGINE_INTUITIVE, collect, &collector) == NQ_OK, "intuitive solve failed");
+    CHECK(collector.seen == 1 && collector.invalid == 0, "intuitive: %llu seen", (unsigned long long)collector.seen);
+    nq_context_free(ctx);
+
+    ctx = nq_context_new(500);
+    collector = (Collector){0};
+    CHECK(nq_solve(ctx, NQ_ENGINE_MIN_CONFLICTS, collect, &collector) == NQ_OK, "min-conflicts solve failed");
+    CHECK(collector.seen == 1 && collector.invalid == 0, "min-conflicts n=500: %llu seen",
+          (unsigned long long)collector.seen);
+    nq_context_free(ctx);
+}
+
+static void test_callback_stops_run(void) {
+    nq_context *ctx = nq_context_new(10);
+    Collector collector = {.stop_after = 5};
+    CHECK(nq_solve(ctx, NQ_ENGINE_BITBOARD, collect, &collector) == NQ_CANCELLED, "stop was not reported");
+    CHECK(collector.seen == 5, "callback ran %llu times after asking to stop", (unsigned long long)collector.seen);
+
+    uint64_t count = 0;
+    CHECK(nq_count(ctx, NQ_ENGINE_BITBOARD, &count) == NQ_OK && count == 724, "context unusable after a stop");
+    nq_context_free(ctx);
+}
+
+typedef struct {
+    nq_context *ctx;
+    atomic_bool started;
+} Canceller;
+
+static void *cancel_at_start(void *data) {
+    Canceller *canceller = data;
+    while (!atomic_load(&canceller->started)) {
+    }
+    nq_cancel(canceller->ctx);
+    return NULL;
+}
+
+/* n=18 takes far longer than the test: only a cancel that is not lost lets it finish. */
+static void test_cancel_at_start(void) {
+    nq_context *ctx = nq_context_new(18);
+    uint64_t count = 0;
+    nq_cancel(ctx);
+    CHECK(nq_count(ctx, NQ_ENGINE_BITBOARD, &count) == NQ_CANCELLED, "cancel before the run was lost");
+
+    Canceller canceller = {.ctx = ctx};
+    atomic_init(&canceller.started, false);
+    pthread_t thread;
+    pthread_create(&thread, NULL, cancel_at_start, &canceller);
+    atomic_store(&canceller.started, true);
+    CHECK(nq_count(ctx, NQ_ENGINE_BITBOARD, &count) == NQ_CANCELLED, "cancel at the start of the run was lost");
+    pthread_join(thread, NULL);
+    nq_context_free(ctx);
+
+    ctx = nq_context_new(8);
+    nq_cancel(ctx);
+    nq_count(ctx, NQ_ENGINE_BITBOARD, &count);
+    CHECK(nq_count(ctx, NQ_ENGINE_BITBOARD, &count) == NQ_OK && count == 92, "a cancel outlived the run it stopped");
+    nq_context_free(ctx);
+}
+
+static void test_iterator(void) {
+    nq_context *ctx = nq_context_new(9);
+    nq_iterator *it = nq_iterator_new(ctx);
+    uint32_t rows[9], previous[9] = {0};
+    uint64_t seen = 0;
+    nq_status status;
+    while ((status = nq_iterator_next(it, rows)) == NQ_OK) {
+        CHECK(is_solution(rows, 9), "iterator returned an invalid board");
+        if (seen > 0) CHECK(comes_before(previous, rows, 9), "iterator out of lexicographic order");
+        memcpy(previous, rows, sizeof(rows));
+        seen++;
+    }
+    CHECK(status == NQ_DONE, "iterator ended with status %d", status);
+    CHECK(seen == 352, "iterator gave %llu solutions", (unsigned long long)seen);
+    CHECK(nq_iterator_next(it, rows) == NQ_DONE, "exhausted iterator restarted");
+    nq_iterator_free(it);
+    nq_context_free(ctx);
+
+    ctx = nq_context_new(40);
+    CHECK(nq_iterator_new(ctx) == NULL, "iterator accepted n=40");
+    nq_context_free(ctx);
+}
+
+static void test_stats(void) {
+    nq_context *ctx = nq_context_new(10);
+    nq_stats stats;
+    CHECK(nq_solve(ctx, NQ_ENGINE_BITBOARD, NULL, NULL) == NQ_OK, "bitboard solve failed");
+    nq_get_stats(ctx, &stats);
+    uint64_t nodes = 0;
+    for (int c = 0; c < NQ_MAX_EXACT_SIZE; c++) nodes += stats.nodes[c];
+    CHECK(stats.solutions == 724 && stats.leaves == 724, "solutions %llu, leaves %llu",
+          (unsigned long long)stats.solutions, (unsigned long long)stats.leaves);
+    CHECK(nodes == stats.operations, "nodes %llu != operations %llu", (unsigned long long)nodes,
+          (unsigned long long)stats.operations);
+
+    nq_stats lockstep;
+    CHECK(nq_solve(ctx, NQ_ENGINE_LOCKSTEP, NULL, NULL) == NQ_OK, "lockstep solve failed");
+    nq_get_stats(ctx, &lockstep);
+    CHECK(lockstep.operations == stats.operations && lockstep.pruned == stats.pruned,
+          "lockstep operations/pruned differ from bitboard");
+    nq_context_free(ctx);
+}
+
+static void test_arguments(void) {
+    CHECK(nq_api_version() == NQ_API_VERSION, "api version mismatch");
+    CHECK(nq_context_new(0) == NULL, "accepted n=0");
+
+    nq_context *ctx = nq_context_new(33);
+    uint64_t count = 0;
+    CHECK(nq_count(ctx, NQ_ENGINE_BITBOARD, &count) == NQ_ERROR_ARGUMENT, "bitboard accepted n=33");
+    CHECK(nq_count(ctx, NQ_ENGINE_COUNT, &count) == NQ_ERROR_ARGUMENT, "accepted an unknown engine");
+    nq_context_free(ctx);
+
+    for (int e = 0; e < NQ_ENGINE_COUNT; e++) {
+        nq_engine engine;
+        CHECK(nq_engine_from_name(nq_engine_name((nq_engine)e), &engine) == NQ_OK && engine == (nq_engine)e,
+              "engine %d does not round-trip through its name", e);
+    }
+    nq_engine engine;
+    CHECK(nq_engine_from_name("nope", &engine) == NQ_ERROR_ARGUMENT, "accepted an unknown name");
+}
+
+int main(void) {
+    test_arguments();
+    test_counts();
+    test_solutions_are_valid();
+    test_callback_stops_run();
+    test_cancel_at_start();
+    test_iterator();
+    test_stats();
+    if (failures) {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("all checks passed\n");
+    return 0;
+}